@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/bench/src/AllocCounter.cpp" "bench/CMakeFiles/DailyAppBench.dir/src/AllocCounter.cpp.o" "gcc" "bench/CMakeFiles/DailyAppBench.dir/src/AllocCounter.cpp.o.d"
+  "/root/repo/bench/src/Harness.cpp" "bench/CMakeFiles/DailyAppBench.dir/src/Harness.cpp.o" "gcc" "bench/CMakeFiles/DailyAppBench.dir/src/Harness.cpp.o.d"
+  "/root/repo/bench/src/main.cpp" "bench/CMakeFiles/DailyAppBench.dir/src/main.cpp.o" "gcc" "bench/CMakeFiles/DailyAppBench.dir/src/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/bench/CMakeFiles/dailyapp_synthetic.dir/DependInfo.cmake"
+  "/root/repo/_bench_build/weight-tracker/CMakeFiles/weight_tracker_lib.dir/DependInfo.cmake"
+  "/root/repo/_bench_build/food-tracker/CMakeFiles/food_tracker_lib.dir/DependInfo.cmake"
+  "/root/repo/_bench_build/common/CMakeFiles/common_lib.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "../bin/DailyAppBench"
+  "../bin/DailyAppBench.pdb"
+  "CMakeFiles/DailyAppBench.dir/src/AllocCounter.cpp.o"
+  "CMakeFiles/DailyAppBench.dir/src/AllocCounter.cpp.o.d"
+  "CMakeFiles/DailyAppBench.dir/src/Harness.cpp.o"
+  "CMakeFiles/DailyAppBench.dir/src/Harness.cpp.o.d"
+  "CMakeFiles/DailyAppBench.dir/src/main.cpp.o"
+  "CMakeFiles/DailyAppBench.dir/src/main.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DailyAppBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
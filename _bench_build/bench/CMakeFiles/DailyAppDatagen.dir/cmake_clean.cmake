@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/DailyAppDatagen"
+  "../bin/DailyAppDatagen.pdb"
+  "CMakeFiles/DailyAppDatagen.dir/src/Datagen.cpp.o"
+  "CMakeFiles/DailyAppDatagen.dir/src/Datagen.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DailyAppDatagen.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
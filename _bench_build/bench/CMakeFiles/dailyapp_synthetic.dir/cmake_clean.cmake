@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/dailyapp_synthetic.dir/src/Synthetic.cpp.o"
+  "CMakeFiles/dailyapp_synthetic.dir/src/Synthetic.cpp.o.d"
+  "libdailyapp_synthetic.a"
+  "libdailyapp_synthetic.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/dailyapp_synthetic.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
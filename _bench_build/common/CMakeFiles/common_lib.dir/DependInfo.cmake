@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/common/src/Chart.cpp" "common/CMakeFiles/common_lib.dir/src/Chart.cpp.o" "gcc" "common/CMakeFiles/common_lib.dir/src/Chart.cpp.o.d"
+  "/root/repo/common/src/Csv.cpp" "common/CMakeFiles/common_lib.dir/src/Csv.cpp.o" "gcc" "common/CMakeFiles/common_lib.dir/src/Csv.cpp.o.d"
+  "/root/repo/common/src/Date.cpp" "common/CMakeFiles/common_lib.dir/src/Date.cpp.o" "gcc" "common/CMakeFiles/common_lib.dir/src/Date.cpp.o.d"
+  "/root/repo/common/src/PlotCache.cpp" "common/CMakeFiles/common_lib.dir/src/PlotCache.cpp.o" "gcc" "common/CMakeFiles/common_lib.dir/src/PlotCache.cpp.o.d"
+  "/root/repo/common/src/Profile.cpp" "common/CMakeFiles/common_lib.dir/src/Profile.cpp.o" "gcc" "common/CMakeFiles/common_lib.dir/src/Profile.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/common_lib.dir/src/Chart.cpp.o"
+  "CMakeFiles/common_lib.dir/src/Chart.cpp.o.d"
+  "CMakeFiles/common_lib.dir/src/Csv.cpp.o"
+  "CMakeFiles/common_lib.dir/src/Csv.cpp.o.d"
+  "CMakeFiles/common_lib.dir/src/Date.cpp.o"
+  "CMakeFiles/common_lib.dir/src/Date.cpp.o.d"
+  "CMakeFiles/common_lib.dir/src/PlotCache.cpp.o"
+  "CMakeFiles/common_lib.dir/src/PlotCache.cpp.o.d"
+  "CMakeFiles/common_lib.dir/src/Profile.cpp.o"
+  "CMakeFiles/common_lib.dir/src/Profile.cpp.o.d"
+  "libcommon_lib.a"
+  "libcommon_lib.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/common_lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/dailyapp/src/BatchRunner.cpp" "dailyapp/CMakeFiles/DailyApp.dir/src/BatchRunner.cpp.o" "gcc" "dailyapp/CMakeFiles/DailyApp.dir/src/BatchRunner.cpp.o.d"
+  "/root/repo/dailyapp/src/ProfileAlloc.cpp" "dailyapp/CMakeFiles/DailyApp.dir/src/ProfileAlloc.cpp.o" "gcc" "dailyapp/CMakeFiles/DailyApp.dir/src/ProfileAlloc.cpp.o.d"
+  "/root/repo/dailyapp/src/Server.cpp" "dailyapp/CMakeFiles/DailyApp.dir/src/Server.cpp.o" "gcc" "dailyapp/CMakeFiles/DailyApp.dir/src/Server.cpp.o.d"
+  "/root/repo/dailyapp/src/main.cpp" "dailyapp/CMakeFiles/DailyApp.dir/src/main.cpp.o" "gcc" "dailyapp/CMakeFiles/DailyApp.dir/src/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/weight-tracker/CMakeFiles/weight_tracker_lib.dir/DependInfo.cmake"
+  "/root/repo/_bench_build/food-tracker/CMakeFiles/food_tracker_lib.dir/DependInfo.cmake"
+  "/root/repo/_bench_build/common/CMakeFiles/common_lib.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
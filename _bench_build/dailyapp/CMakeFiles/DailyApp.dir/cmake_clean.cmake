@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "../bin/DailyApp"
+  "../bin/DailyApp.pdb"
+  "CMakeFiles/DailyApp.dir/src/BatchRunner.cpp.o"
+  "CMakeFiles/DailyApp.dir/src/BatchRunner.cpp.o.d"
+  "CMakeFiles/DailyApp.dir/src/ProfileAlloc.cpp.o"
+  "CMakeFiles/DailyApp.dir/src/ProfileAlloc.cpp.o.d"
+  "CMakeFiles/DailyApp.dir/src/Server.cpp.o"
+  "CMakeFiles/DailyApp.dir/src/Server.cpp.o.d"
+  "CMakeFiles/DailyApp.dir/src/main.cpp.o"
+  "CMakeFiles/DailyApp.dir/src/main.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DailyApp.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
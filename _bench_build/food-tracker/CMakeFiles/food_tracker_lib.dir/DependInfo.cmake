@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/food-tracker/src/Calculator.cpp" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/Calculator.cpp.o" "gcc" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/Calculator.cpp.o.d"
+  "/root/repo/food-tracker/src/FoodCli.cpp" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/FoodCli.cpp.o" "gcc" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/FoodCli.cpp.o.d"
+  "/root/repo/food-tracker/src/History.cpp" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/History.cpp.o" "gcc" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/History.cpp.o.d"
+  "/root/repo/food-tracker/src/ProductDB.cpp" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/ProductDB.cpp.o" "gcc" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/ProductDB.cpp.o.d"
+  "/root/repo/food-tracker/src/ProductImport.cpp" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/ProductImport.cpp.o" "gcc" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/ProductImport.cpp.o.d"
+  "/root/repo/food-tracker/src/Snapshot.cpp" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/Snapshot.cpp.o" "gcc" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/Snapshot.cpp.o.d"
+  "/root/repo/food-tracker/src/TextFold.cpp" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/TextFold.cpp.o" "gcc" "food-tracker/CMakeFiles/food_tracker_lib.dir/src/TextFold.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/common/CMakeFiles/common_lib.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
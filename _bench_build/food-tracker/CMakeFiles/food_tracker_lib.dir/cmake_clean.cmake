@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/food_tracker_lib.dir/src/Calculator.cpp.o"
+  "CMakeFiles/food_tracker_lib.dir/src/Calculator.cpp.o.d"
+  "CMakeFiles/food_tracker_lib.dir/src/FoodCli.cpp.o"
+  "CMakeFiles/food_tracker_lib.dir/src/FoodCli.cpp.o.d"
+  "CMakeFiles/food_tracker_lib.dir/src/History.cpp.o"
+  "CMakeFiles/food_tracker_lib.dir/src/History.cpp.o.d"
+  "CMakeFiles/food_tracker_lib.dir/src/ProductDB.cpp.o"
+  "CMakeFiles/food_tracker_lib.dir/src/ProductDB.cpp.o.d"
+  "CMakeFiles/food_tracker_lib.dir/src/ProductImport.cpp.o"
+  "CMakeFiles/food_tracker_lib.dir/src/ProductImport.cpp.o.d"
+  "CMakeFiles/food_tracker_lib.dir/src/Snapshot.cpp.o"
+  "CMakeFiles/food_tracker_lib.dir/src/Snapshot.cpp.o.d"
+  "CMakeFiles/food_tracker_lib.dir/src/TextFold.cpp.o"
+  "CMakeFiles/food_tracker_lib.dir/src/TextFold.cpp.o.d"
+  "libfood_tracker_lib.a"
+  "libfood_tracker_lib.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/food_tracker_lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
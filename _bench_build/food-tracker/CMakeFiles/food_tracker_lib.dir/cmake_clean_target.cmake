@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libfood_tracker_lib.a"
+)
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/weight-tracker/src/Storage.cpp" "weight-tracker/CMakeFiles/weight_tracker_lib.dir/src/Storage.cpp.o" "gcc" "weight-tracker/CMakeFiles/weight_tracker_lib.dir/src/Storage.cpp.o.d"
+  "/root/repo/weight-tracker/src/Trend.cpp" "weight-tracker/CMakeFiles/weight_tracker_lib.dir/src/Trend.cpp.o" "gcc" "weight-tracker/CMakeFiles/weight_tracker_lib.dir/src/Trend.cpp.o.d"
+  "/root/repo/weight-tracker/src/WeightCli.cpp" "weight-tracker/CMakeFiles/weight_tracker_lib.dir/src/WeightCli.cpp.o" "gcc" "weight-tracker/CMakeFiles/weight_tracker_lib.dir/src/WeightCli.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/common/CMakeFiles/common_lib.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
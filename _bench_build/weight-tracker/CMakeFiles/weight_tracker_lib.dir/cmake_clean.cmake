@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/weight_tracker_lib.dir/src/Storage.cpp.o"
+  "CMakeFiles/weight_tracker_lib.dir/src/Storage.cpp.o.d"
+  "CMakeFiles/weight_tracker_lib.dir/src/Trend.cpp.o"
+  "CMakeFiles/weight_tracker_lib.dir/src/Trend.cpp.o.d"
+  "CMakeFiles/weight_tracker_lib.dir/src/WeightCli.cpp.o"
+  "CMakeFiles/weight_tracker_lib.dir/src/WeightCli.cpp.o.d"
+  "libweight_tracker_lib.a"
+  "libweight_tracker_lib.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/weight_tracker_lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
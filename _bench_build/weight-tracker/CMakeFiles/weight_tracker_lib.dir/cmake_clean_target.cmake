@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libweight_tracker_lib.a"
+)
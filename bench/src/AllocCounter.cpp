@@ -0,0 +1,41 @@
+#include "Harness.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Toutes les allocations du processus passent par ici (threads de
+// parse_parallel compris) : octets et nombre d'appels, sans les libérations.
+
+namespace {
+std::atomic<uint64_t> g_bytes{0};
+std::atomic<uint64_t> g_count{0};
+
+void* counted_alloc(std::size_t n) {
+    g_bytes.fetch_add(n, std::memory_order_relaxed);
+    g_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(n ? n : 1);
+}
+} // namespace
+
+AllocStats alloc_stats() {
+    return {g_bytes.load(std::memory_order_relaxed), g_count.load(std::memory_order_relaxed)};
+}
+
+void* operator new(std::size_t n) {
+    if (void* p = counted_alloc(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {
+    if (void* p = counted_alloc(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return counted_alloc(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return counted_alloc(n); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Csv.hpp"
+#include "Synthetic.hpp"
+
+// DailyAppDatagen : jeux de données synthétiques aux schémas des trackers,
+// un répertoire par utilisateur, à pointer avec DAILYAPP_DATA_DIR au build
+// ou à copier dans data/ (food rebuild recalcule food_history.csv).
+
+namespace {
+
+void print_help() {
+    std::cout <<
+R"(Usage:
+  DailyAppDatagen <répertoire> [options]
+
+  --seed <n>               graine (défaut 42) ; même graine, mêmes fichiers
+  --users <n>              n répertoires user-0001... (défaut : un seul, le répertoire)
+  --products <n>           taille du catalogue (défaut 1000)
+  --years <x>              années d'historique (défaut 1)
+  --start <YYYY-MM-DD>     premier jour (défaut 2020-01-01)
+  --batches-per-week <x>   lots par semaine (défaut 3)
+  --extras-per-week <x>    extras par semaine (défaut 4)
+  --weigh-in-rate <p>      probabilité d'une pesée par jour (défaut 0.8)
+  --alias-density <p>      part des produits avec alias (défaut 0.3)
+  --malformed-rate <p>     part des lignes corrompues (défaut 0)
+)";
+}
+
+bool parse_u64(std::string_view s, uint64_t& out) {
+    double v = 0.0;
+    if (!parse_double(s, v) || v < 0 || v != static_cast<double>(static_cast<uint64_t>(v))) return false;
+    out = static_cast<uint64_t>(v);
+    return true;
+}
+
+bool parse_rate(std::string_view s, double& out) {
+    return parse_double(s, out) && out >= 0.0 && out <= 1.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    if (args.empty() || args[0] == "--help" || args[0] == "-h") {
+        print_help();
+        return args.empty() ? 2 : 0;
+    }
+
+    const std::string root(args[0]);
+    DatasetConfig cfg;
+    uint64_t users = 0;
+    double years = 1.0;
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string_view a = args[i];
+        if (i + 1 >= args.size()) { print_help(); return 2; }
+        const std::string_view v = args[++i];
+        bool ok = true;
+        if (a == "--seed") ok = parse_u64(v, cfg.seed);
+        else if (a == "--users") ok = parse_u64(v, users) && users > 0;
+        else if (a == "--products") ok = parse_u64(v, cfg.products);
+        else if (a == "--years") ok = parse_double(v, years) && years > 0 && years < 500;
+        else if (a == "--start") ok = parse_date_yyyy_mm_dd(v, cfg.start);
+        else if (a == "--batches-per-week") ok = parse_double(v, cfg.batches_per_week) && cfg.batches_per_week >= 0;
+        else if (a == "--extras-per-week") ok = parse_double(v, cfg.extras_per_week) && cfg.extras_per_week >= 0;
+        else if (a == "--weigh-in-rate") ok = parse_rate(v, cfg.weigh_in_rate);
+        else if (a == "--alias-density") ok = parse_rate(v, cfg.alias_density);
+        else if (a == "--malformed-rate") ok = parse_rate(v, cfg.malformed_rate);
+        else ok = false;
+        if (!ok) {
+            std::cerr << "Option invalide: " << a << " " << v << "\n";
+            return 2;
+        }
+    }
+    cfg.days = static_cast<uint64_t>(years * 365.25 + 0.5);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    uint64_t rows = 0, bytes = 0;
+    const uint64_t n = users ? users : 1;
+    for (uint64_t u = 0; u < n; ++u) {
+        std::string dir = root;
+        DatasetConfig user_cfg = cfg;
+        if (users) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "user-%04llu", static_cast<unsigned long long>(u + 1));
+            dir = (std::filesystem::path(root) / name).string();
+            user_cfg.seed = cfg.seed + u; // mélangée dans le générateur
+        }
+        const SyntheticDataset ds = write_synthetic_dataset(dir, user_cfg);
+        if (!ds.error.empty()) {
+            std::cerr << "Écriture impossible: " << ds.error << "\n";
+            return 1;
+        }
+        rows += ds.rows;
+        bytes += ds.bytes;
+    }
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    char summary[200];
+    std::snprintf(summary, sizeof(summary), "%llu répertoire(s), %llu lignes, %.1f Mo en %.2f s\n",
+                  static_cast<unsigned long long>(n), static_cast<unsigned long long>(rows),
+                  static_cast<double>(bytes) / 1e6, s);
+    std::cout << summary;
+    return 0;
+}
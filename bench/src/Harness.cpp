@@ -0,0 +1,143 @@
+#include "Harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+#include "Csv.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Sample {
+    double seconds = 0.0;
+    AllocStats alloc;
+};
+
+Sample time_loop(const BenchCase& c, uint64_t iterations) {
+    const AllocStats a0 = alloc_stats();
+    const auto t0 = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) c.op();
+    const auto t1 = Clock::now();
+    const AllocStats a1 = alloc_stats();
+    return {std::chrono::duration<double>(t1 - t0).count(), {a1.bytes - a0.bytes, a1.count - a0.count}};
+}
+
+// "clé":valeur sur une ligne de results_to_json
+bool field(std::string_view line, std::string_view key, std::string_view& value) {
+    std::string pat = "\"";
+    pat += key;
+    pat += "\":";
+    const size_t at = line.find(pat);
+    if (at == std::string_view::npos) return false;
+    size_t b = at + pat.size();
+    if (b < line.size() && line[b] == '"') {
+        const size_t e = line.find('"', b + 1);
+        if (e == std::string_view::npos) return false;
+        value = line.substr(b + 1, e - b - 1);
+        return true;
+    }
+    size_t e = line.find_first_of(",}", b);
+    if (e == std::string_view::npos) e = line.size();
+    value = line.substr(b, e - b);
+    return true;
+}
+
+} // namespace
+
+BenchResult run_case(const BenchCase& c, const BenchOptions& opt) {
+    c.op(); // chauffe : caches, snapshots, pages du fichier
+
+    uint64_t iterations = 1;
+    for (;;) {
+        const Sample s = time_loop(c, iterations);
+        if (s.seconds >= opt.min_time_s || iterations >= (1ull << 40)) break;
+        // vise min_time_s avec une marge, au plus x10 par tour
+        const double target = opt.min_time_s * 1.2 / std::max(s.seconds, 1e-9) * static_cast<double>(iterations);
+        iterations = std::max(iterations + 1, std::min(iterations * 10, static_cast<uint64_t>(target)));
+    }
+
+    std::vector<double> ns;
+    AllocStats alloc{};
+    for (int r = 0; r < std::max(1, opt.repetitions); ++r) {
+        const Sample s = time_loop(c, iterations);
+        ns.push_back(s.seconds * 1e9 / static_cast<double>(iterations));
+        alloc.bytes += s.alloc.bytes;
+        alloc.count += s.alloc.count;
+    }
+    std::sort(ns.begin(), ns.end());
+
+    BenchResult r;
+    r.name = c.name;
+    r.scale = c.scale;
+    r.iterations = iterations;
+    r.ns_per_op = ns[ns.size() / 2];
+    const double ops = static_cast<double>(iterations) * static_cast<double>(ns.size());
+    r.alloc_bytes_per_op = static_cast<double>(alloc.bytes) / ops;
+    r.allocs_per_op = static_cast<double>(alloc.count) / ops;
+    r.items_per_sec = c.items * 1e9 / r.ns_per_op;
+    r.bytes_per_sec = c.bytes * 1e9 / r.ns_per_op;
+    return r;
+}
+
+std::string results_to_json(const std::vector<BenchResult>& results) {
+    std::string out = "{\"schema\":1,\"results\":[\n";
+    char buf[512];
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::snprintf(buf, sizeof(buf),
+                      "{\"name\":\"%s\",\"scale\":%llu,\"iterations\":%llu,\"ns_per_op\":%.1f,"
+                      "\"alloc_bytes_per_op\":%.1f,\"allocs_per_op\":%.2f,"
+                      "\"items_per_sec\":%.1f,\"bytes_per_sec\":%.1f}%s\n",
+                      r.name.c_str(), static_cast<unsigned long long>(r.scale),
+                      static_cast<unsigned long long>(r.iterations), r.ns_per_op,
+                      r.alloc_bytes_per_op, r.allocs_per_op, r.items_per_sec, r.bytes_per_sec,
+                      i + 1 < results.size() ? "," : "");
+        out += buf;
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool load_baseline(const std::string& path, std::vector<BenchResult>& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string_view name, scale, ns;
+        if (!field(line, "name", name) || !field(line, "scale", scale) || !field(line, "ns_per_op", ns)) continue;
+        BenchResult r;
+        r.name = std::string(name);
+        int s = 0;
+        if (!parse_int(scale, s) || !parse_double(ns, r.ns_per_op)) continue;
+        r.scale = static_cast<uint64_t>(s);
+        out.push_back(std::move(r));
+    }
+    return !out.empty();
+}
+
+int compare_to_baseline(const std::vector<BenchResult>& current,
+                        const std::vector<BenchResult>& baseline,
+                        double threshold_pct, std::ostream& out) {
+    int regressions = 0;
+    char buf[256];
+    for (const BenchResult& r : current) {
+        const auto it = std::find_if(baseline.begin(), baseline.end(), [&](const BenchResult& b) {
+            return b.name == r.name && b.scale == r.scale;
+        });
+        if (it == baseline.end() || it->ns_per_op <= 0.0) continue;
+        const double delta = (r.ns_per_op / it->ns_per_op - 1.0) * 100.0;
+        const bool slower = delta > threshold_pct;
+        regressions += slower;
+        std::snprintf(buf, sizeof(buf), "%-36s %8llu  %12.1f -> %12.1f ns/op  %+7.1f %%%s\n",
+                      r.name.c_str(), static_cast<unsigned long long>(r.scale),
+                      it->ns_per_op, r.ns_per_op, delta, slower ? "  REGRESSION" : "");
+        out << buf;
+    }
+    return regressions;
+}
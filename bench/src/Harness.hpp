@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Compteurs de AllocCounter.cpp (operator new remplacé pour tout le binaire).
+struct AllocStats {
+    uint64_t bytes = 0;
+    uint64_t count = 0;
+};
+AllocStats alloc_stats();
+
+// Un cas mesuré : `op` est appelé en boucle (préparation hors mesure).
+// items / bytes : volume traité par appel, pour le débit.
+struct BenchCase {
+    std::string name;
+    uint64_t scale = 0;
+    double items = 1.0;
+    double bytes = 0.0;
+    std::function<void()> op;
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t scale = 0;
+    uint64_t iterations = 0;
+    double ns_per_op = 0.0;        // médiane des répétitions
+    double alloc_bytes_per_op = 0.0;
+    double allocs_per_op = 0.0;
+    double items_per_sec = 0.0;
+    double bytes_per_sec = 0.0;
+};
+
+struct BenchOptions {
+    double min_time_s = 0.2; // par répétition
+    int repetitions = 5;
+};
+
+// Calibre le nombre d'itérations pour tenir min_time_s, puis mesure
+// `repetitions` fois (un appel de chauffe avant tout).
+BenchResult run_case(const BenchCase& c, const BenchOptions& opt);
+
+// JSON, un résultat par ligne :
+// {"schema":1,"results":[
+// {"name":"...","scale":N,"iterations":N,"ns_per_op":X,...},
+// ]}
+std::string results_to_json(const std::vector<BenchResult>& results);
+
+// Relit un fichier écrit par results_to_json ; faux s'il est illisible.
+bool load_baseline(const std::string& path, std::vector<BenchResult>& out);
+
+// Compare ns_per_op aux cas de même nom et échelle de la baseline ; écrit un
+// rapport et renvoie le nombre de régressions au-delà de `threshold_pct`.
+int compare_to_baseline(const std::vector<BenchResult>& current,
+                        const std::vector<BenchResult>& baseline,
+                        double threshold_pct, std::ostream& out);
@@ -0,0 +1,265 @@
+#include "Synthetic.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+// xorshift64* : même graine, mêmes fichiers sur toutes les plateformes
+struct Rng {
+    uint64_t s;
+    explicit Rng(uint64_t seed) : s(seed ? seed : 0x9e3779b97f4a7c15ull) {}
+    uint64_t next() {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 0x2545f4914f6cdd1dull;
+    }
+    uint64_t below(uint64_t n) { return n ? next() % n : 0; }
+    double uniform(double lo, double hi) { return lo + (hi - lo) * static_cast<double>(next() >> 11) * 0x1.0p-53; }
+    bool chance(double p) { return uniform(0.0, 1.0) < p; }
+    // nombre d'événements d'un jour pour `per_week` en moyenne (Poisson)
+    int poisson(double mean) {
+        const double l = std::exp(-mean);
+        int k = 0;
+        for (double p = uniform(0.0, 1.0); p > l; p *= uniform(0.0, 1.0)) ++k;
+        return k;
+    }
+};
+
+// Graine d'un flux : chaque fichier a le sien, ajouter un paramètre à l'un ne
+// change pas les autres.
+uint64_t mix(uint64_t seed, uint64_t stream) {
+    uint64_t z = seed + 0x9e3779b97f4a7c15ull * (stream + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+constexpr std::string_view WORDS[] = {
+    "poulet", "riz", "pain", "lentilles", "yaourt", "pomme", "thon", "avoine", "brocoli", "fromage",
+    "oeuf", "tofu", "banane", "quinoa", "saumon", "lait", "pates", "carotte", "amandes", "haricots"};
+constexpr std::string_view QUALIFIERS[] = {"complet", "bio", "nature", "light", "frais", "surgele", "maison"};
+constexpr std::string_view COMMENTS[] = {"", "", "", "semaine", "meal prep", "\"midi, soir\"", "reste"};
+
+template <size_t N>
+std::string_view pick(Rng& rng, const std::string_view (&words)[N]) {
+    return words[rng.below(N)];
+}
+
+// Unité d'un produit tirée de son numéro : les lots la retrouvent sans
+// garder le catalogue en mémoire.
+bool is_liquid(uint64_t product) { return mix(product, 99) % 6 == 0; }
+
+// Produits populaires plus souvent consommés (tirage biaisé vers 0).
+uint64_t popular_product(Rng& rng, uint64_t n) {
+    const double u = rng.uniform(0.0, 1.0);
+    return std::min(n - 1, static_cast<uint64_t>(static_cast<double>(n) * u * u));
+}
+
+// Fichier écrit par blocs de 1 Mio ; la première erreur (ouverture,
+// écriture, fermeture) est gardée et les écritures suivantes sont ignorées.
+class Writer {
+public:
+    explicit Writer(std::string path) : path_(std::move(path)), f_(std::fopen(path_.c_str(), "wb")) {
+        if (!f_) fail();
+        buf_.reserve(kChunk);
+    }
+    ~Writer() {
+        if (f_) std::fclose(f_);
+    }
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // ligne sans '\n' ; corrompue avec la probabilité `malformed`
+    void row(std::string_view line, Rng& rng, double malformed) {
+        if (malformed > 0.0 && rng.chance(malformed)) {
+            switch (rng.below(3)) {
+                case 0: line = line.substr(0, line.find(',')); break;      // champs manquants
+                case 1: buf_ += "2019-02-30,"; break;                      // date impossible, colonnes décalées
+                default: line = line.substr(0, 1 + rng.below(line.size())); // écriture interrompue
+            }
+        }
+        buf_ += line;
+        buf_ += '\n';
+        ++rows;
+        if (buf_.size() >= kChunk) flush();
+    }
+    void header(std::string_view line) {
+        buf_ += line;
+        buf_ += '\n';
+    }
+    void flush() {
+        if (f_ && !buf_.empty()) {
+            if (std::fwrite(buf_.data(), 1, buf_.size(), f_) == buf_.size()) bytes += buf_.size();
+            else fail();
+        }
+        buf_.clear();
+    }
+    // Vide le tampon et ferme le fichier ; faux et `error` rempli si une
+    // écriture a échoué.
+    bool close(std::string& error) {
+        flush();
+        if (f_) {
+            const bool closed = std::fclose(f_) == 0;
+            f_ = nullptr;
+            if (!closed) fail();
+        }
+        if (error_.empty()) return true;
+        error = error_;
+        return false;
+    }
+
+    uint64_t rows = 0, bytes = 0;
+
+private:
+    static constexpr size_t kChunk = 1 << 20;
+
+    void fail() {
+        if (error_.empty()) error_ = path_ + ": " + std::strerror(errno);
+        if (f_) std::fclose(f_);
+        f_ = nullptr;
+    }
+
+    std::string path_;
+    std::FILE* f_;
+    std::string buf_;
+    std::string error_;
+};
+
+// Ferme `w` : ses lignes sont comptées dans `ds`, ou son erreur notée.
+void finish(Writer& w, SyntheticDataset& ds) {
+    if (!w.close(ds.error)) return;
+    ds.rows += w.rows;
+    ds.bytes += w.bytes;
+}
+
+void write_products(const std::string& path, const DatasetConfig& cfg, SyntheticDataset& ds) {
+    Writer w(path);
+    w.header("id,name,unit,kcal_per_100,prot_per_100,fiber_per_100,aliases");
+    Rng rng(mix(cfg.seed, 1));
+    char line[256];
+    std::string aliases;
+    for (uint64_t i = 0; i < cfg.products; ++i) {
+        const std::string_view a = pick(rng, WORDS), q = pick(rng, QUALIFIERS);
+        aliases.clear();
+        if (rng.chance(cfg.alias_density)) {
+            const int n = 1 + static_cast<int>(rng.below(3));
+            for (int k = 0; k < n; ++k) {
+                if (k) aliases += '|';
+                aliases += pick(rng, WORDS);
+                aliases += std::to_string(i);
+                if (k) aliases += pick(rng, QUALIFIERS).substr(0, 3);
+            }
+        }
+        const bool liquid = is_liquid(i);
+        const double kcal = liquid ? rng.uniform(0, 120) : rng.uniform(15, 650);
+        std::snprintf(line, sizeof(line), "p%llu,%.*s %.*s %llu,%s,%.1f,%.1f,%.1f,%s",
+                      static_cast<unsigned long long>(i), static_cast<int>(a.size()), a.data(),
+                      static_cast<int>(q.size()), q.data(), static_cast<unsigned long long>(i),
+                      liquid ? "mL" : "g", kcal, rng.uniform(0, std::min(40.0, kcal / 8)),
+                      rng.uniform(0, 12), aliases.c_str());
+        w.row(line, rng, cfg.malformed_rate);
+    }
+    finish(w, ds);
+}
+
+void write_batches(const std::string& path, const DatasetConfig& cfg, SyntheticDataset& ds) {
+    Writer w(path);
+    w.header("batch_id,start_date,days,product_id,qty,unit,comment");
+    Rng rng(mix(cfg.seed, 2));
+    char line[256];
+    uint64_t id = 0;
+    for (uint64_t d = 0; d < cfg.days && cfg.products > 0; ++d) {
+        const std::string date = format_date(add_days(cfg.start, static_cast<int>(d)));
+        for (int n = rng.poisson(cfg.batches_per_week / 7.0); n > 0; --n) {
+            const uint64_t p = popular_product(rng, cfg.products);
+            const std::string_view comment = pick(rng, COMMENTS);
+            std::snprintf(line, sizeof(line), "b%llu,%s,%d,p%llu,%.0f,%s,%.*s",
+                          static_cast<unsigned long long>(id++), date.c_str(),
+                          1 + static_cast<int>(rng.below(7)), static_cast<unsigned long long>(p),
+                          rng.uniform(80, 1500), is_liquid(p) ? "mL" : "g",
+                          static_cast<int>(comment.size()), comment.data());
+            w.row(line, rng, cfg.malformed_rate);
+        }
+    }
+    finish(w, ds);
+}
+
+void write_extras(const std::string& path, const DatasetConfig& cfg, SyntheticDataset& ds) {
+    Writer w(path);
+    w.header("date,kcal,prot,fiber,comment");
+    Rng rng(mix(cfg.seed, 3));
+    char line[256];
+    for (uint64_t d = 0; d < cfg.days; ++d) {
+        const std::string date = format_date(add_days(cfg.start, static_cast<int>(d)));
+        for (int n = rng.poisson(cfg.extras_per_week / 7.0); n > 0; --n) {
+            const double kcal = rng.uniform(40, 900);
+            const std::string_view comment = pick(rng, COMMENTS);
+            std::snprintf(line, sizeof(line), "%s,%.0f,%.1f,%.1f,%.*s", date.c_str(), kcal,
+                          rng.uniform(0, kcal / 25), rng.uniform(0, 8),
+                          static_cast<int>(comment.size()), comment.data());
+            w.row(line, rng, cfg.malformed_rate);
+        }
+    }
+    finish(w, ds);
+}
+
+void write_weight(const std::string& path, const DatasetConfig& cfg, SyntheticDataset& ds) {
+    Writer w(path);
+    w.header("date,weight_kg");
+    Rng rng(mix(cfg.seed, 4));
+    char line[64];
+    // tendance lente (phases de perte / reprise) + bruit journalier
+    double level = rng.uniform(60, 95), drift = 0.0;
+    for (uint64_t d = 0; d < cfg.days; ++d) {
+        if (d % 60 == 0) drift = rng.uniform(-0.05, 0.04);
+        level = std::clamp(level + drift, 45.0, 140.0);
+        if (!rng.chance(cfg.weigh_in_rate)) continue;
+        std::snprintf(line, sizeof(line), "%s,%.1f", format_date(add_days(cfg.start, static_cast<int>(d))).c_str(),
+                      level + rng.uniform(-0.6, 0.6));
+        w.row(line, rng, cfg.malformed_rate);
+    }
+    finish(w, ds);
+}
+
+} // namespace
+
+SyntheticDataset write_synthetic_dataset(const std::string& dir, const DatasetConfig& cfg) {
+    namespace fs = std::filesystem;
+    SyntheticDataset ds;
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) {
+        ds.error = dir + ": " + ec.message();
+        return ds;
+    }
+    ds.products = (fs::path(dir) / "food_products.csv").string();
+    ds.batches = (fs::path(dir) / "food_batches.csv").string();
+    ds.extras = (fs::path(dir) / "food_extras.csv").string();
+    ds.weight = (fs::path(dir) / "weight_history.csv").string();
+    ds.start = cfg.start;
+    ds.days = cfg.days;
+
+    write_products(ds.products, cfg, ds);
+    if (ds.error.empty()) write_batches(ds.batches, cfg, ds);
+    if (ds.error.empty()) write_extras(ds.extras, cfg, ds);
+    if (ds.error.empty()) write_weight(ds.weight, cfg, ds);
+    return ds;
+}
+
+DatasetConfig bench_config(uint64_t scale) {
+    DatasetConfig cfg;
+    cfg.products = scale;
+    cfg.start = make_date(2000, 1, 1);
+    cfg.days = scale;
+    cfg.weigh_in_rate = 1.0;
+    return cfg;
+}
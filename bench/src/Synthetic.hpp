@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "Date.hpp"
+
+// Jeu de données déterministe aux schémas des trackers : même graine, mêmes
+// octets. Écrit en flux (tampon fixe par fichier) : la mémoire ne dépend pas
+// de la taille produite. Lots, extras et pesées sont dans l'ordre des dates.
+struct DatasetConfig {
+    uint64_t seed = 42;
+    uint64_t products = 1000;
+    Date start = make_date(2020, 1, 1);
+    uint64_t days = 365;
+    double batches_per_week = 3.0;
+    double extras_per_week = 4.0;
+    double weigh_in_rate = 0.8;   // probabilité d'une pesée par jour
+    double alias_density = 0.3;   // part des produits qui ont des alias
+    double malformed_rate = 0.0;  // part des lignes corrompues (date, champ, coupure)
+};
+
+struct SyntheticDataset {
+    std::string products, batches, extras, weight;
+    Date start{};
+    uint64_t days = 0;
+    uint64_t rows = 0;  // lignes de données écrites, tous fichiers
+    uint64_t bytes = 0;
+    std::string error;  // premier échec d'écriture ("chemin: raison"), vide si tout est écrit
+};
+
+// S'arrête au premier fichier qui ne peut être écrit entièrement (voir error).
+SyntheticDataset write_synthetic_dataset(const std::string& dir, const DatasetConfig& cfg);
+
+// Échelle du bench : `scale` produits, `scale` jours, une pesée par jour.
+DatasetConfig bench_config(uint64_t scale);
@@ -0,0 +1,262 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Calculator.hpp"
+#include "Csv.hpp"
+#include "Harness.hpp"
+#include "History.hpp"
+#include "ProductDB.hpp"
+#include "Snapshot.hpp"
+#include "Storage.hpp"
+#include "Synthetic.hpp"
+
+namespace {
+
+void print_help() {
+    std::cout <<
+R"(DailyAppBench : chemins chauds des trackers sur des données synthétiques
+
+Usage:
+  DailyAppBench [--scales 1000,10000] [--filter <texte>] [--min-time <s>]
+                [--repetitions <n>] [--json <fichier|->]
+                [--baseline <fichier.json>] [--threshold <pct>] [--keep-data]
+
+  --json       résultats JSON (défaut : sur la sortie standard)
+  --baseline   compare ns/op aux résultats enregistrés ; code de sortie 1 si
+               un cas est plus lent que --threshold % (défaut 10)
+)";
+}
+
+// Sortie jetée (print_grouped_history) : mesure le formatage, pas le terminal.
+class NullBuf : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+template <class T>
+void keep(const T& v) {
+    asm volatile("" : : "g"(&v) : "memory"); // empêche d'éliminer le calcul
+}
+
+double file_size(const std::string& path) {
+    std::error_code ec;
+    const auto n = std::filesystem::file_size(path, ec);
+    return ec ? 0.0 : static_cast<double>(n);
+}
+
+// Cas d'une échelle ; l'état partagé vit aussi longtemps que les lambdas.
+std::vector<BenchCase> make_cases(const SyntheticDataset& ds, uint64_t scale, const std::string& dir) {
+    const Date start = ds.start;
+    const int days = static_cast<int>(ds.days);
+    const double products_bytes = file_size(ds.products);
+
+    const std::string history_csv = (std::filesystem::path(dir) / "food_history.csv").string();
+    auto db = std::make_shared<ProductDB>();
+    db->load(ds.products);
+    rebuild_food_history_csv(*db, ds.batches, ds.extras, history_csv);
+
+    auto lines = std::make_shared<std::vector<std::string>>(read_lines(ds.products));
+    auto queries = std::make_shared<std::vector<std::string>>();
+    for (uint64_t i = 0; i < 1024; ++i) {
+        std::string& q = queries->emplace_back("p");
+        q += std::to_string((i * 7919) % scale);
+    }
+    auto terms = std::make_shared<std::vector<std::string>>(
+        std::vector<std::string>{"poulet", "riz 12", "lent", "yaourt pomme", "saumon 7", "tofu"});
+    auto cursor = std::make_shared<size_t>(0);
+
+    const std::string upsert_csv = (std::filesystem::path(dir) / "weight_upsert.csv").string();
+    std::filesystem::copy_file(ds.weight, upsert_csv, std::filesystem::copy_options::overwrite_existing);
+    auto upsert = std::make_shared<Storage>(upsert_csv);
+
+    // champs numériques du catalogue (kcal, prot, fiber) : parse / écriture
+    // par la couche from_chars / to_chars, et la référence std::stod / to_string
+    auto numbers = std::make_shared<std::vector<std::string>>();
+    auto values = std::make_shared<std::vector<double>>();
+    double number_bytes = 0.0;
+    for (size_t i = 1; i < lines->size(); ++i) {
+        const auto cols = split_csv_simple((*lines)[i]);
+        for (size_t c = 3; c < 6 && c < cols.size(); ++c) {
+            double v = 0.0;
+            if (!parse_double(cols[c], v)) continue;
+            numbers->push_back(cols[c]);
+            values->push_back(v);
+            number_bytes += static_cast<double>(cols[c].size());
+        }
+    }
+    const double nnumbers = static_cast<double>(numbers->size());
+
+    const double nlines = static_cast<double>(lines->size());
+    std::vector<BenchCase> cases;
+    cases.push_back({"csv/read_lines", scale, nlines, products_bytes, [ds] {
+        keep(read_lines(ds.products));
+    }});
+    cases.push_back({"csv/split_csv_simple", scale, nlines, products_bytes, [lines] {
+        for (const auto& l : *lines) keep(split_csv_simple(l));
+    }});
+    cases.push_back({"csv/parse_double", scale, nnumbers, number_bytes, [numbers] {
+        double v = 0.0;
+        for (const auto& n : *numbers) {
+            parse_double(n, v);
+            keep(v);
+        }
+    }});
+    cases.push_back({"csv/std::stod (ref)", scale, nnumbers, number_bytes, [numbers] {
+        for (const auto& n : *numbers) keep(std::stod(n));
+    }});
+    cases.push_back({"csv/append_double", scale, nnumbers, 0.0, [values] {
+        std::string out;
+        for (double v : *values) {
+            out.clear();
+            append_double(out, v);
+            keep(out);
+        }
+    }});
+    cases.push_back({"csv/std::to_string (ref)", scale, nnumbers, 0.0, [values] {
+        for (double v : *values) keep(std::to_string(v));
+    }});
+    cases.push_back({"food/ProductDB::load", scale, static_cast<double>(scale), products_bytes, [ds] {
+        ProductDB fresh;
+        fresh.load(ds.products);
+        keep(fresh);
+    }});
+    cases.push_back({"food/ProductDB::resolve", scale, 1.0, 0.0, [db, queries, cursor] {
+        keep(db->resolve((*queries)[(*cursor)++ % queries->size()]));
+    }});
+    cases.push_back({"food/ProductDB::search", scale, 1.0, 0.0, [db, terms, cursor] {
+        keep(db->search((*terms)[(*cursor)++ % terms->size()], 20));
+    }});
+    cases.push_back({"food/compute_daily_macros", scale, static_cast<double>(days),
+                     file_size(ds.batches) + file_size(ds.extras), [db, ds, start, days] {
+        keep(compute_daily_kcal_and_prot_and_fiber(*db, ds.batches, ds.extras, start, days));
+    }});
+    cases.push_back({"food/rebuild_food_history_csv", scale, static_cast<double>(days),
+                     file_size(ds.batches) + file_size(ds.extras), [db, ds, history_csv] {
+        NullBuf nb;
+        std::ostream err(&nb);
+        keep(rebuild_food_history_csv(*db, ds.batches, ds.extras, history_csv, err));
+    }});
+    cases.push_back({"food/print_grouped_history", scale, static_cast<double>(days), file_size(history_csv), [history_csv] {
+        NullBuf nb;
+        std::ostream out(&nb);
+        keep(print_grouped_history(load_history_snapshot(history_csv), out));
+    }});
+    cases.push_back({"weight/Storage::loadAll", scale, static_cast<double>(scale), file_size(ds.weight), [ds] {
+        Storage storage(ds.weight);
+        keep(storage.loadAll());
+    }});
+    // une pesée remplacée par appel : journal + compaction tous les 512 appels
+    cases.push_back({"weight/Storage::upsertByDate", scale, 1.0, 0.0, [upsert, start, scale, cursor] {
+        const Date d = add_days(start, static_cast<int>(((*cursor)++ * 31) % scale));
+        keep(upsert->upsertByDate({d, 70.0 + static_cast<double>(*cursor % 100) / 10.0}));
+    }});
+    return cases;
+}
+
+bool parse_scales(std::string_view s, std::vector<uint64_t>& out) {
+    out.clear();
+    while (!s.empty()) {
+        const size_t comma = s.find(',');
+        int v = 0;
+        if (!parse_int(s.substr(0, comma), v) || v < 8) return false;
+        out.push_back(static_cast<uint64_t>(v));
+        s = comma == std::string_view::npos ? std::string_view{} : s.substr(comma + 1);
+    }
+    return !out.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::vector<uint64_t> scales{1000, 10000};
+    std::string filter, json_path = "-", baseline_path;
+    double threshold = 10.0;
+    bool keep_data = false;
+    BenchOptions opt;
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string_view a = args[i];
+        const bool has_value = i + 1 < args.size();
+        if (a == "--help" || a == "-h") { print_help(); return 0; }
+        if (a == "--keep-data") { keep_data = true; continue; }
+        if (!has_value) { print_help(); return 2; }
+        const std::string_view v = args[++i];
+        bool ok = true;
+        if (a == "--scales") ok = parse_scales(v, scales);
+        else if (a == "--filter") filter = v;
+        else if (a == "--min-time") ok = parse_double(v, opt.min_time_s) && opt.min_time_s > 0;
+        else if (a == "--repetitions") ok = parse_int(v, opt.repetitions) && opt.repetitions > 0;
+        else if (a == "--json") json_path = v;
+        else if (a == "--baseline") baseline_path = v;
+        else if (a == "--threshold") ok = parse_double(v, threshold);
+        else ok = false;
+        if (!ok) { print_help(); return 2; }
+    }
+
+    std::vector<BenchResult> baseline;
+    if (!baseline_path.empty() && !load_baseline(baseline_path, baseline)) {
+        std::cerr << "Baseline illisible: " << baseline_path << "\n";
+        return 2;
+    }
+
+    const auto root = std::filesystem::temp_directory_path() / ("dailyapp-bench-" + std::to_string(::getpid()));
+    std::vector<BenchResult> results;
+    for (const uint64_t scale : scales) {
+        const std::string dir = (root / std::to_string(scale)).string();
+        const SyntheticDataset ds = write_synthetic_dataset(dir, bench_config(scale));
+        if (!ds.error.empty()) {
+            std::cerr << "Écriture impossible: " << ds.error << "\n";
+            return 1;
+        }
+        for (const BenchCase& c : make_cases(ds, scale, dir)) {
+            if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+            results.push_back(run_case(c, opt));
+            const BenchResult& r = results.back();
+            char line[200];
+            std::snprintf(line, sizeof(line), "%-36s %8llu  %14.1f ns/op  %12.1f B/op  %10.1f allocs/op\n",
+                          r.name.c_str(), static_cast<unsigned long long>(scale), r.ns_per_op,
+                          r.alloc_bytes_per_op, r.allocs_per_op);
+            std::cerr << line;
+        }
+    }
+    if (!keep_data) {
+        std::error_code ec;
+        std::filesystem::remove_all(root, ec);
+    } else {
+        std::cerr << "Données: " << root.string() << "\n";
+    }
+
+    const std::string json = results_to_json(results);
+    if (json_path == "-") {
+        std::cout << json;
+    } else {
+        std::ofstream f(json_path, std::ios::trunc);
+        f << json;
+        if (!f) {
+            std::cerr << "Écriture impossible: " << json_path << "\n";
+            return 2;
+        }
+    }
+
+    if (!baseline.empty()) {
+        std::cerr << "\nComparaison à " << baseline_path << " (seuil " << threshold << " %):\n";
+        const int regressions = compare_to_baseline(results, baseline, threshold, std::cerr);
+        if (regressions > 0) {
+            std::cerr << regressions << " régression(s)\n";
+            return 1;
+        }
+    }
+    return 0;
+}
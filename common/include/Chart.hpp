@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Graphiques en courbes rendus sans dépendance externe : SVG (texte) et PNG
+// (rastérisation logicielle anticrénelée, police bitmap 5x7 ASCII, deflate
+// Huffman fixe). L'axe x est en jours (Date::serial), un ou deux axes y.
+
+struct Rgb {
+  uint8_t r = 0, g = 0, b = 0;
+};
+
+// Palette "tab:" de matplotlib, celle des anciens scripts analytics.
+namespace chart_colors {
+  inline constexpr Rgb Blue{0x1f, 0x77, 0xb4};
+  inline constexpr Rgb Red{0xd6, 0x27, 0x28};
+  inline constexpr Rgb Green{0x2c, 0xa0, 0x2c};
+}
+
+enum class Marker { None, Circle, Cross };
+
+struct ChartSeries {
+  std::string label;
+  std::vector<int32_t> days;  // Date::serial, croissants
+  std::vector<double> values;
+  Rgb color{};
+  int axis = 0;               // 0 = gauche, 1 = droite
+  bool dashed = false;
+  Marker marker = Marker::None;
+  double width = 2.0;
+};
+
+// Bande horizontale semi-transparente (plage cible).
+struct ChartBand {
+  double lo = 0.0, hi = 0.0;
+  Rgb color{};
+  double alpha = 0.08;
+  int axis = 0;
+};
+
+struct ChartAxis {
+  std::string label;
+  double min = 0.0, max = 0.0; // min == max : ajusté aux données (+5 %)
+};
+
+struct Chart {
+  std::string title;
+  std::string x_label;
+  ChartAxis y[2];
+  bool dual_axis = false;
+  bool legend = false;         // sous la zone de tracé, une ligne
+  std::vector<ChartBand> bands;
+  std::vector<ChartSeries> series;
+  int width = 1200, height = 600;
+};
+
+// À incrémenter dès que le rendu d'un même Chart change (cache des plots).
+inline constexpr uint32_t CHART_RENDERER_VERSION = 1;
+
+// Empreinte de tout ce qui détermine l'image : données, paramètres, version.
+uint64_t chart_fingerprint(const Chart& chart);
+
+// Vrai si au moins une série a un point.
+bool chart_has_data(const Chart& chart);
+
+std::string render_chart_svg(const Chart& chart);
+
+// Fichier temporaire puis rename ; faux si l'écriture échoue.
+bool write_chart_svg(const Chart& chart, const std::string& path);
+bool write_chart_png(const Chart& chart, const std::string& path);
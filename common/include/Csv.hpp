@@ -0,0 +1,170 @@
+#pragma once
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct Date;
+
+std::string trim(std::string s);
+std::string_view trim_view(std::string_view s);
+std::vector<std::string> split_csv_simple(const std::string& line);
+
+// read all non-empty lines (excluding header optionally)
+std::vector<std::string> read_lines(const std::string& path);
+void append_line(const std::string& path, const std::string& line); // AppendBatch d'une ligne
+bool file_exists(const std::string& path);
+
+// Nom de fichier temporaire à côté de `path`, unique par processus et par
+// appel (écritures concurrentes d'un même fichier avant rename).
+std::string temp_path_for(const std::string& path);
+
+// Lignes ajoutées en bloc à la fin d'un fichier : le '\n' final du fichier
+// n'est vérifié qu'une fois et tout part en un seul write() (+ fsync si
+// `durable`). Un commit raté laisse le fichier intact : un fichier neuf est
+// écrit à côté puis renommé, un ajout incomplet est tronqué à la taille
+// d'origine.
+class AppendBatch {
+public:
+  explicit AppendBatch(std::string path, bool durable = false);
+
+  void add(std::string_view line); // sans '\n'
+  size_t lines() const { return lines_; }
+  bool commit();                   // vide le lot, même en cas d'échec
+
+private:
+  std::string path_;
+  std::string buf_;
+  size_t lines_ = 0;
+  bool durable_ = false;
+};
+
+// Met un champ entre guillemets s'il contient le séparateur, un guillemet ou
+// un saut de ligne (les guillemets internes sont doublés, les sauts de ligne
+// deviennent des espaces : un enregistrement tient sur une ligne).
+std::string csv_escape(std::string_view field);
+void append_csv_field(std::string& out, std::string_view field); // même règle, ajouté à `out`
+
+// --- Nombres ---
+// Lecture et écriture par std::from_chars / std::to_chars : format "C" quelle
+// que soit la locale, sans allocation ni exception.
+
+// Le champ déjà découpé doit être lu en entier ("+" initial toléré) ; faux
+// sinon, pour inf / nan ou hors plage (`out` est alors inchangé).
+bool parse_double(std::string_view s, double& out);
+bool parse_int(std::string_view s, int& out);
+
+// Plus courte écriture qui se relit exactement : 675 -> "675", 0.1 -> "0.1".
+void append_double(std::string& out, double v);
+void append_int(std::string& out, long long v);
+std::string format_double(double v);
+
+// Dichotomie sur un CSV trié par date (premier champ YYYY-MM-DD) : offset de
+// la première ligne de text[begin..] datée >= from, text.size() s'il n'y en a
+// pas ; `begin` doit être un début de ligne. nullopt si une ligne sondée n'a
+// pas de date lisible (fichier édité à la main : lecture complète).
+std::optional<size_t> seek_date_sorted(std::string_view text, size_t begin, const Date& from);
+
+// Fichier projeté en mémoire en lecture seule ; data() est vide si le
+// fichier est absent ou de taille nulle.
+class MappedFile {
+public:
+  enum class Access { Sequential, Random };
+
+  MappedFile() = default;
+  explicit MappedFile(const std::string& path, Access access = Access::Sequential);
+  ~MappedFile();
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool is_open() const { return open_; }
+  std::string_view data() const { return {static_cast<const char*>(addr_), size_}; }
+
+private:
+  void* addr_ = nullptr;
+  size_t size_ = 0;
+  bool open_ = false;
+};
+
+// Découpe une ligne en champs trimés, avec support des champs "entre
+// guillemets". Les vues pointent dans `line`, ou dans `scratch` quand un
+// champ contient des "" échappés ; elles restent valides jusqu'au prochain
+// appel avec le même scratch. Faux si un champ ouvert par un guillemet
+// n'est pas refermé dans la ligne (ligne coupée) : il va alors jusqu'au bout.
+bool split_csv_fields(std::string_view line, std::vector<std::string_view>& out,
+                      std::string& scratch, char sep = ',');
+
+// Découpage d'un texte en enregistrements complets, pour le traitement par
+// blocs, avec la règle de CsvReader : un enregistrement par ligne physique.
+// Longueur du plus long préfixe de `text` fait d'enregistrements complets.
+size_t complete_records_prefix(std::string_view text);
+// Au plus `parts` tranches contiguës de tailles voisines, coupées sur des
+// fins d'enregistrement ; `text` doit commencer sur un début d'enregistrement.
+std::vector<std::string_view> split_record_ranges(std::string_view text, size_t parts);
+
+// --- Parse parallèle par tranches ---
+// Nombre de threads de parse : DAILYAPP_PARSE_THREADS si défini et > 0,
+// sinon un par coeur ; set_parse_threads(1) force le parse série.
+unsigned parse_threads();
+void set_parse_threads(unsigned n); // 0 = un par coeur
+
+// En dessous, un fichier est parsé en une seule tranche.
+inline constexpr size_t PARALLEL_PARSE_MIN_BYTES = size_t{1} << 20;
+
+// Tranches de `body` (enregistrements complets, en-tête déjà retiré) à
+// parser en parallèle : une par thread, ou une seule pour un petit texte.
+std::vector<std::string_view> parse_ranges(std::string_view body,
+                                           size_t min_bytes = PARALLEL_PARSE_MIN_BYTES);
+
+// parse(tranche, part) pour chaque tranche, un thread par tranche (le
+// thread appelant prend la première) ; les parts sont rendues dans l'ordre
+// du texte, leur concaténation donne donc le même résultat qu'en série.
+template <class Part, class Parse>
+std::vector<Part> parse_parallel(std::span<const std::string_view> ranges, Parse&& parse) {
+  std::vector<Part> parts(ranges.size());
+  if (ranges.size() <= 1) {
+    for (size_t i = 0; i < ranges.size(); ++i) parse(ranges[i], parts[i]);
+    return parts;
+  }
+  std::vector<std::thread> workers;
+  workers.reserve(ranges.size() - 1);
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    workers.emplace_back([&, i] { parse(ranges[i], parts[i]); });
+  }
+  parse(ranges[0], parts[0]);
+  for (auto& w : workers) w.join();
+  return parts;
+}
+
+// Lecteur ligne à ligne sur un fichier mappé : aucune copie de ligne, les
+// champs d'une ligne sont des string_view valides jusqu'au next() suivant.
+// Un enregistrement est une ligne physique, les lignes vides sont ignorées ;
+// un guillemet n'ouvre un champ qu'en début de champ (split_csv_fields) et
+// protège le séparateur, jamais le saut de ligne.
+class CsvReader {
+public:
+  explicit CsvReader(const std::string& path, char sep = ',');
+  static CsvReader from_text(std::string_view text, char sep = ','); // texte déjà en mémoire
+
+  bool is_open() const { return ok_; }
+  bool next(std::span<const std::string_view>& row);
+  size_t line_number() const { return line_; } // ligne (1-based) de la dernière lecture
+  std::string_view record() const { return record_; } // texte brut de la dernière lecture
+  bool open_quote() const { return open_quote_; } // dernière ligne coupée dans un champ "..."
+  std::string_view remaining() const { return rest_; } // texte non encore lu
+
+private:
+  MappedFile file_;
+  std::string_view rest_;
+  bool ok_ = false;
+  char sep_ = ',';
+  size_t line_ = 0;
+  std::string_view record_;
+  bool open_quote_ = false;
+  std::vector<std::string_view> fields_;
+  std::string scratch_;
+};
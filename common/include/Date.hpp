@@ -0,0 +1,105 @@
+#pragma once
+#include <span>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <compare>
+
+// Date civile (grégorien proleptique) stockée sous forme de numéro de jour
+// sériel : 0 = 1970-01-01. Tout le calcul est entier et constexpr, sans
+// passer par std::tm / mktime / le fuseau horaire.
+struct Date {
+  int32_t serial = 0;
+
+  friend constexpr auto operator<=>(const Date&, const Date&) = default;
+};
+
+struct Ymd {
+  int y = 0, m = 0, d = 0;
+};
+
+constexpr bool is_leap_year(int y) {
+  return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+constexpr int days_in_month(int y, int m) {
+  constexpr int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return (m == 2 && is_leap_year(y)) ? 29 : dim[m - 1];
+}
+
+constexpr bool is_valid_ymd(int y, int m, int d) {
+  return m >= 1 && m <= 12 && d >= 1 && d <= days_in_month(y, m);
+}
+
+// days_from_civil / civil_from_days (H. Hinnant), ères de 400 ans.
+constexpr Date make_date(int y, int m, int d) {
+  y -= (m <= 2);
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const int yoe = y - era * 400;                                   // [0, 399]
+  const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;  // [0, 365]
+  const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;           // [0, 146096]
+  return Date{era * 146097 + doe - 719468};
+}
+
+constexpr Ymd to_ymd(const Date& dt) {
+  const int z = dt.serial + 719468;
+  const int era = (z >= 0 ? z : z - 146096) / 146097;
+  const int doe = z - era * 146097;
+  const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int mp = (5 * doy + 2) / 153;
+  const int d = doy - (153 * mp + 2) / 5 + 1;
+  const int m = mp < 10 ? mp + 3 : mp - 9;
+  return Ymd{yoe + era * 400 + (m <= 2), m, d};
+}
+
+constexpr Date add_days(const Date& dt, int delta) {
+  return Date{dt.serial + delta};
+}
+
+// end - start, en jours (négatif si end < start)
+constexpr int days_between(const Date& start, const Date& end) {
+  return end.serial - start.serial;
+}
+
+// start..end inclus, 0 si end < start
+constexpr int days_between_inclusive(const Date& start, const Date& end) {
+  return end < start ? 0 : days_between(start, end) + 1;
+}
+
+// 0 = lundi ... 6 = dimanche (1970-01-01 était un jeudi)
+constexpr int weekday(const Date& dt) {
+  const int r = (dt.serial + 3) % 7;
+  return r < 0 ? r + 7 : r;
+}
+
+// Buckets : lundi de la semaine ISO, premier jour du mois.
+constexpr Date week_start(const Date& dt) {
+  return add_days(dt, -weekday(dt));
+}
+
+constexpr Date month_start(const Date& dt) {
+  const Ymd c = to_ymd(dt);
+  return make_date(c.y, c.m, 1);
+}
+
+bool parse_date_yyyy_mm_dd(std::string_view s, Date& out); // strict, rejette 2026-02-31
+std::string format_date(const Date& dt);
+void format_date_to(const Date& dt, char* out); // écrit exactement 10 caractères
+
+Date today_local(); // date du jour dans le fuseau local
+
+// Plage de dates incluse ; une borne absente laisse la plage ouverte.
+struct DateRange {
+  Date from{INT32_MIN};
+  Date to{INT32_MAX};
+
+  constexpr bool bounded() const { return from.serial != INT32_MIN || to.serial != INT32_MAX; }
+  constexpr bool contains(const Date& d) const { return from <= d && d <= to; }
+};
+
+// Options de plage des commandes history, lues à args[i] :
+//   --from YYYY-MM-DD, --to YYYY-MM-DD, --last N (N derniers jours, aujourd'hui inclus)
+// None : args[i] n'en est pas une ; Ok : i avance sur la valeur consommée.
+enum class RangeArg { None, Ok, Invalid };
+RangeArg parse_range_arg(std::span<const std::string_view> args, size_t& i, DateRange& range);
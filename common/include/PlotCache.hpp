@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Cache de graphiques façon outil de build : `<sortie>.plot` mémorise
+// l'empreinte des entrées (données + paramètres + version du moteur) du
+// dernier rendu réussi, qui est sauté tant qu'elle ne change pas.
+
+// Empreinte 64 bits incrémentale (non cryptographique).
+class Fingerprint {
+public:
+  Fingerprint& add(uint64_t v);
+  Fingerprint& add(double v);
+  Fingerprint& add(std::string_view bytes);
+  uint64_t value() const { return h_; }
+
+private:
+  uint64_t h_ = 0x9E3779B97F4A7C15ull;
+};
+
+enum class PlotStatus { Hit, Rendered, Queued, Failed };
+
+// Un graphique à produire : `render` écrit toutes les `outputs` (fichier
+// temporaire puis rename) et détaille ses erreurs dans `err`.
+struct PlotJob {
+  std::string sidecar; // <nom>.plot
+  uint64_t key = 0;
+  std::vector<std::string> outputs;
+  std::function<bool(std::ostream& err)> render;
+};
+
+// Rendu immédiat (history --wait) : sauté si `sidecar` contient déjà `key`
+// et que toutes les `outputs` existent, la clé n'étant enregistrée qu'après
+// un rendu réussi. Un verrou (flock sur `sidecar`.lock) sérialise les
+// rendus concurrents : le second attend puis trouve le travail du premier.
+PlotStatus run_plot(const PlotJob& job, std::ostream& err);
+
+// Hit si le cache est déjà valide, sinon Queued : le rendu part dans un
+// worker détaché et la commande rend la main. Les demandes se fusionnent :
+// `sidecar`.request garde la clé la plus récente et un worker dont la clé a
+// été remplacée entre-temps s'arrête sans rendre.
+PlotStatus submit_plot(PlotJob job);
+
+// Process : double fork détaché de la console (CLI, batch) ; Thread : thread
+// détaché (DailyApp serve, on ne forke pas un processus multi-thread).
+enum class PlotWorker { Process, Thread };
+void set_plot_worker(PlotWorker worker);
+void wait_plot_workers(); // threads en cours (arrêt du démon)
+
+// `sidecar`.status : dernier état connu (pending, running, done, failed).
+struct PlotState {
+  std::string state;
+  uint64_t key = 0;
+  long long updated = 0; // secondes Unix
+  std::string message;   // première ligne d'erreur si failed
+};
+bool read_plot_state(const std::string& sidecar, PlotState& state);
+
+// Fichier entier dans l'empreinte (sources d'un rendu externe) ; faux s'il
+// est illisible.
+bool fingerprint_file(Fingerprint& fp, const std::string& path);
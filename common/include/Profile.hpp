@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Profilage par zones (DailyApp --profile) : appels, temps total / propre /
+// max et allocations par zone nommée, compteurs cumulés (lignes, octets lus),
+// trace Chrome / Perfetto en option. Les macros PROFILE_* n'existent qu'avec
+// DAILYAPP_PROFILING (option CMake) et disparaissent sinon ; compilées, une
+// zone hors --profile coûte la lecture d'un booléen.
+
+namespace profile {
+
+#ifdef DAILYAPP_PROFILING
+inline constexpr bool compiled = true;
+#else
+inline constexpr bool compiled = false;
+#endif
+
+// Active la collecte ; `trace` garde aussi chaque occurrence (write_trace).
+void start(bool trace);
+bool active();
+
+void count(const char* counter, uint64_t n);
+void note_alloc(size_t bytes); // operator new du binaire (DailyApp)
+
+// Zones triées par temps total, compteurs, appels système du processus.
+void report(std::ostream& out);
+// Format "Trace Event" (chrome://tracing, ui.perfetto.dev).
+bool write_trace(const std::string& path);
+
+// Zone chronométrée de sa construction à sa destruction. `name` doit vivre
+// jusqu'à la fin du processus (littéral).
+class Zone {
+public:
+  explicit Zone(const char* name);
+  ~Zone();
+  Zone(const Zone&) = delete;
+  Zone& operator=(const Zone&) = delete;
+
+private:
+  const char* name_;
+  Zone* parent_ = nullptr;
+  uint64_t start_ns_ = 0;
+  uint64_t child_ns_ = 0;
+  uint64_t allocs_ = 0, alloc_bytes_ = 0;
+  bool on_ = false;
+};
+
+} // namespace profile
+
+#ifdef DAILYAPP_PROFILING
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_ZONE(name) ::profile::Zone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#define PROFILE_COUNT(counter, n) ::profile::count(counter, static_cast<uint64_t>(n))
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_COUNT(counter, n) ((void)0)
+#endif
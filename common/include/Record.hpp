@@ -0,0 +1,253 @@
+#pragma once
+#include "Csv.hpp"
+#include "Date.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Enregistrements CSV décrits une fois, à la compilation : un tracker
+// déclare la liste de ses colonnes (nom d'en-tête + membre) dans une
+// spécialisation de record::Schema, le codec en déduit le parse d'une ligne
+// déjà découpée, l'écriture d'une ligne, l'en-tête et sa validation.
+//
+//   template <> struct record::Schema<WeightEntry> {
+//     static constexpr auto columns = std::tuple{
+//       record::column("date", &WeightEntry::date),
+//       record::column("weight_kg", &WeightEntry::weightKg),
+//     };
+//   };
+//
+// Avec des membres string_view (ProductView...), decode n'alloue rien : les
+// champs pointent dans le texte lu, comme ceux de CsvReader.
+
+namespace record {
+
+// --- Codecs de champ ---
+// Un type de membre se lit et s'écrit via Codec<M> ; les types propres à un
+// tracker (Unit...) se déclarent par spécialisation à côté du type.
+template <class M>
+struct Codec;
+
+template <>
+struct Codec<Date> {
+  static constexpr std::string_view invalid = "date invalide";
+  static bool decode(std::string_view s, Date& out) { return parse_date_yyyy_mm_dd(s, out); }
+  static void encode(std::string& out, const Date& d) {
+    char buf[10];
+    format_date_to(d, buf);
+    out.append(buf, sizeof(buf));
+  }
+};
+
+template <>
+struct Codec<double> {
+  static constexpr std::string_view invalid = "nombre invalide";
+  static bool decode(std::string_view s, double& out) { return parse_double(s, out); }
+  static void encode(std::string& out, double v) { append_double(out, v); }
+};
+
+template <>
+struct Codec<int> {
+  static constexpr std::string_view invalid = "entier invalide";
+  static bool decode(std::string_view s, int& out) { return parse_int(s, out); }
+  static void encode(std::string& out, int v) { append_int(out, v); }
+};
+
+template <>
+struct Codec<std::string_view> {
+  static constexpr std::string_view invalid = "texte invalide";
+  static bool decode(std::string_view s, std::string_view& out) { out = s; return true; }
+  static void encode(std::string& out, std::string_view s) { append_csv_field(out, s); }
+};
+
+template <>
+struct Codec<std::string> {
+  static constexpr std::string_view invalid = "texte invalide";
+  static bool decode(std::string_view s, std::string& out) { out.assign(s); return true; }
+  static void encode(std::string& out, const std::string& s) { append_csv_field(out, s); }
+};
+
+// --- Descripteurs de colonnes ---
+template <class T, class M>
+struct Column {
+  std::string_view name;
+  M T::*member = nullptr;
+  bool required = true;               // sinon : colonne finale, absente = M{}
+  bool (*valid)(const M&) = nullptr;  // contrainte en plus du format
+
+  constexpr Column checked(bool (*check)(const M&)) const {
+    Column c = *this;
+    c.valid = check;
+    return c;
+  }
+};
+
+template <class T, class M>
+constexpr Column<T, M> column(std::string_view name, M T::*member) {
+  return {name, member, true, nullptr};
+}
+
+template <class T, class M>
+constexpr Column<T, M> optional_column(std::string_view name, M T::*member) {
+  return {name, member, false, nullptr};
+}
+
+template <class M>
+constexpr bool positive(const M& v) { return v > M{}; }
+
+// Spécialisé par type d'enregistrement : static constexpr auto columns.
+template <class T>
+struct Schema;
+
+template <class T>
+inline constexpr size_t column_count = std::tuple_size_v<std::remove_cv_t<decltype(Schema<T>::columns)>>;
+
+// Nombre de colonnes obligatoires ; les facultatives doivent être en fin de
+// ligne (vérifié à la compilation par decode).
+template <class T>
+consteval size_t required_count() {
+  return std::apply([](const auto&... c) { return (size_t{c.required} + ... + 0); }, Schema<T>::columns);
+}
+
+template <class T>
+consteval bool optional_columns_last() {
+  bool optional_seen = false, ordered = true;
+  std::apply([&](const auto&... c) {
+    ((c.required ? void(ordered = ordered && !optional_seen) : void(optional_seen = true)), ...);
+  }, Schema<T>::columns);
+  return ordered;
+}
+
+template <class T>
+inline constexpr size_t required_columns = required_count<T>();
+
+template <class T>
+constexpr std::string_view column_name(size_t i) {
+  std::string_view name;
+  size_t k = 0;
+  std::apply([&](const auto&... c) { ((k++ == i ? (name = c.name, 0) : 0), ...); }, Schema<T>::columns);
+  return name;
+}
+
+// --- En-tête ---
+template <class T>
+std::string header() {
+  std::string out;
+  std::apply([&](const auto&... c) {
+    size_t k = 0;
+    ((out += (k++ ? "," : ""), out += c.name), ...);
+  }, Schema<T>::columns);
+  return out;
+}
+
+// Vrai si les colonnes présentes portent les noms du schéma, dans l'ordre ;
+// les facultatives peuvent manquer, les colonnes en plus sont ignorées.
+template <class T>
+bool check_header(std::span<const std::string_view> fields) {
+  if (fields.size() < required_columns<T>) return false;
+  bool ok = true;
+  size_t k = 0;
+  std::apply([&](const auto&... c) {
+    ((ok = ok && (k >= fields.size() || fields[k] == c.name), ++k), ...);
+  }, Schema<T>::columns);
+  return ok;
+}
+
+// --- Lignes ---
+struct RowError {
+  size_t column = 0;        // index dans le schéma
+  std::string_view reason;  // littéral
+};
+
+template <class T>
+bool decode(std::span<const std::string_view> fields, T& out, RowError& err) {
+  static_assert(optional_columns_last<T>(), "record::Schema : colonne obligatoire après une facultative");
+  bool ok = true;
+  size_t k = 0;
+  auto one = [&](const auto& c) {
+    if (!ok) return;
+    using M = std::remove_cvref_t<decltype(out.*(c.member))>;
+    const size_t i = k++;
+    M& dst = out.*(c.member);
+    if (i >= fields.size()) {
+      if (c.required) { err = {i, "champ manquant"}; ok = false; }
+      else dst = M{};
+      return;
+    }
+    if (!Codec<M>::decode(fields[i], dst)) { err = {i, Codec<M>::invalid}; ok = false; return; }
+    if (c.valid && !c.valid(dst)) { err = {i, "valeur hors plage"}; ok = false; }
+  };
+  std::apply([&](const auto&... c) { (one(c), ...); }, Schema<T>::columns);
+  return ok;
+}
+
+template <class T>
+bool decode(std::span<const std::string_view> fields, T& out) {
+  RowError err;
+  return decode(fields, out, err);
+}
+
+// Ligne lue par CsvReader : une ligne coupée dans un champ entre guillemets
+// ("midi, soi) est rejetée comme telle, pas lue avec un champ tronqué.
+template <class T>
+bool decode(const CsvReader& reader, std::span<const std::string_view> fields, T& out, RowError& err) {
+  if (reader.open_quote()) {
+    err = {std::min(fields.size(), column_count<T>) - 1, "guillemet non fermé"};
+    return false;
+  }
+  return decode(fields, out, err);
+}
+
+// Ajoute la ligne (sans '\n') à `out` ; les textes sont échappés si besoin.
+template <class T>
+void encode(const T& rec, std::string& out) {
+  std::apply([&](const auto&... c) {
+    size_t k = 0;
+    ((k++ ? void(out += ',') : void(),
+      Codec<std::remove_cvref_t<decltype(rec.*(c.member))>>::encode(out, rec.*(c.member))), ...);
+  }, Schema<T>::columns);
+}
+
+template <class T>
+std::string encode(const T& rec) {
+  std::string out;
+  encode(rec, out);
+  return out;
+}
+
+// Bilan des lignes rejetées d'un texte : leur nombre et la première.
+struct RowIssues {
+  size_t rejected = 0;
+  const char* at = nullptr;  // début de la première ligne rejetée, dans le texte lu
+  RowError first;
+
+  void note(std::string_view record, const RowError& err) {
+    if (rejected++ == 0) { at = record.data(); first = err; }
+  }
+  // `later` vient d'une tranche suivante du même texte (parse_parallel)
+  void merge(const RowIssues& later) {
+    if (later.rejected == 0) return;
+    if (rejected == 0) { at = later.at; first = later.first; }
+    rejected += later.rejected;
+  }
+};
+
+// Avertit sur `err` d'un en-tête inattendu ou de lignes rejetées dans `text`
+// (contenu de `path`) ; rien si tout est conforme.
+template <class T>
+void report(std::ostream& err, std::string_view path, std::string_view text,
+            bool header_ok, const RowIssues& issues) {
+  if (!header_ok) err << path << ": en-tête inattendu (attendu : " << header<T>() << ")\n";
+  if (issues.rejected == 0) return;
+  const auto line = 1 + std::count(text.data(), issues.at, '\n');
+  err << path << ": " << issues.rejected << " ligne(s) ignorée(s) ; ligne " << line
+      << ", colonne " << column_name<T>(issues.first.column) << " : " << issues.first.reason << "\n";
+}
+
+} // namespace record
@@ -0,0 +1,766 @@
+#include "Chart.hpp"
+#include "Csv.hpp"
+#include "Date.hpp"
+#include "PlotCache.hpp"
+#include "Profile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string_view>
+
+namespace {
+
+// --- Mise en page commune SVG / PNG ---
+
+constexpr int FONT_SCALE = 2;                 // glyphes 5x7 agrandis x2
+constexpr int CHAR_W = 6 * FONT_SCALE;        // avance (5 + 1 d'espacement)
+constexpr int CHAR_H = 7 * FONT_SCALE;
+constexpr double DASH_ON = 8.0, DASH_OFF = 4.0;
+constexpr double MARKER_R = 3.5;
+
+struct Tick {
+  double pos = 0.0; // pixel
+  std::string label;
+};
+
+struct Layout {
+  double l = 0, t = 0, r = 0, b = 0; // zone de tracé
+  double x0 = 0, x1 = 1;             // jours
+  double y0[2] = {0, 0}, y1[2] = {1, 1};
+  std::vector<Tick> xticks;
+  std::vector<Tick> yticks[2];
+  double title_y = 0, xlabel_y = 0, legend_y = 0;
+
+  double px(double day) const { return l + (day - x0) / (x1 - x0) * (r - l); }
+  double py(int axis, double v) const { return b - (v - y0[axis]) / (y1[axis] - y0[axis]) * (b - t); }
+};
+
+size_t text_chars(std::string_view s) {
+  size_t n = 0;
+  for (unsigned char c : s) n += (c & 0xC0) != 0x80; // un glyphe par point de code
+  return n;
+}
+
+double text_width(std::string_view s) {
+  const size_t n = text_chars(s);
+  return n ? static_cast<double>(n * CHAR_W - FONT_SCALE) : 0.0;
+}
+
+double nice_step(double raw) {
+  if (!(raw > 0)) return 1.0;
+  const double e = std::pow(10.0, std::floor(std::log10(raw)));
+  const double f = raw / e;
+  return (f <= 1 ? 1 : f <= 2 ? 2 : f <= 5 ? 5 : 10) * e;
+}
+
+std::string format_tick(double v, double step) {
+  const int decimals = step >= 1 ? 0 : static_cast<int>(std::ceil(-std::log10(step) - 1e-9));
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.*f", decimals, std::abs(v) < step * 1e-6 ? 0.0 : v);
+  return buf;
+}
+
+void y_range(const Chart& c, int axis, double& lo, double& hi) {
+  if (c.y[axis].min != c.y[axis].max) {
+    lo = c.y[axis].min;
+    hi = c.y[axis].max;
+    return;
+  }
+  lo = std::numeric_limits<double>::infinity();
+  hi = -lo;
+  for (const auto& s : c.series) {
+    if (s.axis != axis) continue;
+    for (double v : s.values) { lo = std::min(lo, v); hi = std::max(hi, v); }
+  }
+  for (const auto& band : c.bands) {
+    if (band.axis != axis) continue;
+    lo = std::min(lo, band.lo);
+    hi = std::max(hi, band.hi);
+  }
+  if (lo > hi) { lo = 0; hi = 1; }
+  if (lo == hi) { lo -= 1; hi += 1; }
+  const double pad = (hi - lo) * 0.05;
+  lo -= pad;
+  hi += pad;
+}
+
+std::vector<double> y_tick_values(double lo, double hi, double& step) {
+  step = nice_step((hi - lo) / 6.0);
+  std::vector<double> v;
+  for (double y = std::ceil(lo / step - 1e-9) * step; y <= hi + step * 1e-9; y += step) v.push_back(y);
+  return v;
+}
+
+// Graduations de dates : jours / semaines sur une courte période, sinon
+// débuts de mois (pas de 1, 2, 3, 6, 12... mois), 7 au plus.
+std::vector<std::pair<int32_t, std::string>> x_tick_days(int32_t x0, int32_t x1) {
+  std::vector<std::pair<int32_t, std::string>> ticks;
+  const int32_t span = x1 - x0;
+  if (span <= 60) {
+    int step = 28;
+    for (int s : {1, 2, 3, 7, 14, 21, 28}) {
+      if (span / s <= 7) { step = s; break; }
+    }
+    const int offset = step % 7 == 0 ? 4 : 0; // 1970-01-05 est un lundi
+    for (int32_t d = x0; d <= x1; ++d) {
+      if (((d - offset) % step + step) % step == 0) ticks.emplace_back(d, format_date(Date{d}));
+    }
+    return ticks;
+  }
+  const double months = span / 30.44;
+  int step = 12;
+  for (int s : {1, 2, 3, 6, 12}) {
+    if (months / s <= 7) { step = s; break; }
+  }
+  while (months / step > 7) step *= 2;
+  Ymd m = to_ymd(month_start(Date{x0}));
+  for (;;) {
+    const Date d = make_date(m.y, m.m, 1);
+    if (d.serial > x1) break;
+    if (d.serial >= x0 && (m.y * 12 + m.m - 1) % step == 0) {
+      std::string label = format_date(d).substr(0, step >= 12 ? 4 : 7);
+      ticks.emplace_back(d.serial, std::move(label));
+    }
+    if (++m.m > 12) { m.m = 1; ++m.y; }
+  }
+  return ticks;
+}
+
+Layout make_layout(const Chart& c) {
+  Layout L;
+  int32_t lo = std::numeric_limits<int32_t>::max(), hi = std::numeric_limits<int32_t>::min();
+  for (const auto& s : c.series) {
+    for (int32_t d : s.days) { lo = std::min(lo, d); hi = std::max(hi, d); }
+  }
+  if (lo > hi) { lo = 0; hi = 1; }
+  if (lo == hi) { --lo; ++hi; }
+  L.x0 = lo;
+  L.x1 = hi;
+
+  const int axes = c.dual_axis ? 2 : 1;
+  double tick_w[2] = {0, 0};
+  double steps[2] = {1, 1};
+  std::vector<double> yv[2];
+  for (int a = 0; a < axes; ++a) {
+    y_range(c, a, L.y0[a], L.y1[a]);
+    yv[a] = y_tick_values(L.y0[a], L.y1[a], steps[a]);
+    for (double v : yv[a]) tick_w[a] = std::max(tick_w[a], text_width(format_tick(v, steps[a])));
+  }
+
+  const double gap = 8;
+  L.t = c.title.empty() ? 16 : 16 + CHAR_H + 16;
+  L.l = 12 + (c.y[0].label.empty() ? 0 : CHAR_H + gap) + tick_w[0] + gap + 5;
+  L.r = c.width - (c.dual_axis ? 12 + (c.y[1].label.empty() ? 0 : CHAR_H + gap) + tick_w[1] + gap + 5 : 30);
+  double bottom = c.height - 12;
+  if (c.legend) { L.legend_y = bottom - CHAR_H; bottom -= CHAR_H + 20; }
+  if (!c.x_label.empty()) { L.xlabel_y = bottom - CHAR_H; bottom -= CHAR_H + gap; }
+  L.b = bottom - (5 + gap + CHAR_H);
+  L.title_y = 16;
+
+  for (int a = 0; a < axes; ++a) {
+    for (double v : yv[a]) L.yticks[a].push_back({L.py(a, v), format_tick(v, steps[a])});
+  }
+  for (auto& [d, label] : x_tick_days(lo, hi)) L.xticks.push_back({L.px(d), std::move(label)});
+  return L;
+}
+
+std::string hex(Rgb c) {
+  char buf[8];
+  std::snprintf(buf, sizeof(buf), "#%02x%02x%02x", c.r, c.g, c.b);
+  return buf;
+}
+
+constexpr Rgb BLACK{0, 0, 0};
+constexpr Rgb GRID{0xdd, 0xdd, 0xdd};
+
+// --- SVG ---
+
+std::string xml_escape(std::string_view s) {
+  std::string out;
+  for (char ch : s) {
+    switch (ch) {
+      case '&': out += "&amp;"; break;
+      case '<': out += "&lt;"; break;
+      case '>': out += "&gt;"; break;
+      case '"': out += "&quot;"; break;
+      default: out += ch;
+    }
+  }
+  return out;
+}
+
+std::string num(double v) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.1f", v);
+  return buf;
+}
+
+std::string opacity(double a) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.3g", a);
+  return buf;
+}
+
+void svg_text(std::string& o, double x, double y, std::string_view text, const char* anchor,
+              bool vertical = false) {
+  // ajouts successifs plutôt qu'une chaîne de operator+ (faux -Wrestrict de GCC 12)
+  o += "<text x=\"";
+  o += num(x);
+  o += "\" y=\"";
+  o += num(y);
+  o += "\" text-anchor=\"";
+  o += anchor;
+  o += '"';
+  if (vertical) {
+    o += " transform=\"rotate(-90 ";
+    o += num(x);
+    o += ' ';
+    o += num(y);
+    o += ")\"";
+  }
+  o += '>';
+  o += xml_escape(text);
+  o += "</text>\n";
+}
+
+void svg_marker(std::string& o, Marker m, double x, double y, Rgb color) {
+  if (m == Marker::Circle) {
+    o += "<circle cx=\"" + num(x) + "\" cy=\"" + num(y) + "\" r=\"" + num(MARKER_R) +
+         "\" fill=\"" + hex(color) + "\"/>\n";
+  } else if (m == Marker::Cross) {
+    const double k = MARKER_R;
+    o += "<path d=\"M" + num(x - k) + " " + num(y - k) + "L" + num(x + k) + " " + num(y + k) +
+         "M" + num(x - k) + " " + num(y + k) + "L" + num(x + k) + " " + num(y - k) +
+         "\" stroke=\"" + hex(color) + "\" stroke-width=\"1.5\"/>\n";
+  }
+}
+
+void svg_stroke_attrs(std::string& o, const ChartSeries& s) {
+  o += " fill=\"none\" stroke=\"" + hex(s.color) + "\" stroke-width=\"" + num(s.width) +
+       "\" stroke-linejoin=\"round\" stroke-linecap=\"round\"";
+  if (s.dashed) o += " stroke-dasharray=\"" + num(DASH_ON) + "," + num(DASH_OFF) + "\"";
+}
+
+// Largeur d'une entrée de légende : trait d'exemple + libellé.
+constexpr double LEGEND_SAMPLE = 30, LEGEND_GAP = 8, LEGEND_SPACING = 36;
+
+double legend_width(const Chart& c) {
+  double w = 0;
+  for (const auto& s : c.series) w += LEGEND_SAMPLE + LEGEND_GAP + text_width(s.label) + LEGEND_SPACING;
+  return c.series.empty() ? 0 : w - LEGEND_SPACING;
+}
+
+// --- PNG : rastérisation ---
+
+// Police 5x7 (ASCII 32..126), une colonne par octet, bit 0 = ligne du haut.
+constexpr uint8_t FONT5X7[95][5] = {
+  {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00},
+  {0x14,0x7F,0x14,0x7F,0x14}, {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62},
+  {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00}, {0x00,0x1C,0x22,0x41,0x00},
+  {0x00,0x41,0x22,0x1C,0x00}, {0x08,0x2A,0x1C,0x2A,0x08}, {0x08,0x08,0x3E,0x08,0x08},
+  {0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00},
+  {0x20,0x10,0x08,0x04,0x02}, {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00},
+  {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31}, {0x18,0x14,0x12,0x7F,0x10},
+  {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03},
+  {0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, {0x00,0x36,0x36,0x00,0x00},
+  {0x00,0x56,0x36,0x00,0x00}, {0x08,0x14,0x22,0x41,0x00}, {0x14,0x14,0x14,0x14,0x14},
+  {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x51,0x09,0x06}, {0x32,0x49,0x79,0x41,0x3E},
+  {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+  {0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01},
+  {0x3E,0x41,0x49,0x49,0x7A}, {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00},
+  {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41}, {0x7F,0x40,0x40,0x40,0x40},
+  {0x7F,0x02,0x0C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+  {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46},
+  {0x46,0x49,0x49,0x49,0x31}, {0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F},
+  {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F}, {0x63,0x14,0x08,0x14,0x63},
+  {0x07,0x08,0x70,0x08,0x07}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x7F,0x41,0x41,0x00},
+  {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x7F,0x00}, {0x04,0x02,0x01,0x02,0x04},
+  {0x40,0x40,0x40,0x40,0x40}, {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78},
+  {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20}, {0x38,0x44,0x44,0x48,0x7F},
+  {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x0C,0x52,0x52,0x52,0x3E},
+  {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x44,0x3D,0x00},
+  {0x7F,0x10,0x28,0x44,0x00}, {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78},
+  {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38}, {0x7C,0x14,0x14,0x14,0x08},
+  {0x08,0x14,0x14,0x18,0x7C}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20},
+  {0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C},
+  {0x3C,0x40,0x30,0x40,0x3C}, {0x44,0x28,0x10,0x28,0x44}, {0x0C,0x50,0x50,0x50,0x3C},
+  {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00}, {0x00,0x00,0x7F,0x00,0x00},
+  {0x00,0x41,0x36,0x08,0x00}, {0x08,0x04,0x08,0x10,0x08},
+};
+
+struct Canvas {
+  int w, h;
+  std::vector<uint8_t> rgb;
+  std::vector<float> mask; // couverture d'une série en cours (max des primitives)
+  int mx0, my0, mx1, my1;  // zone touchée du masque
+
+  Canvas(int width, int height)
+      : w(width), h(height), rgb(size_t(width) * height * 3, 255), mask(size_t(width) * height, 0.f) {
+    reset_mask_box();
+  }
+
+  void reset_mask_box() { mx0 = w; my0 = h; mx1 = -1; my1 = -1; }
+
+  void blend(int x, int y, Rgb c, double a) {
+    if (x < 0 || y < 0 || x >= w || y >= h || a <= 0) return;
+    uint8_t* p = &rgb[(size_t(y) * w + x) * 3];
+    p[0] = static_cast<uint8_t>(std::lround(p[0] + (c.r - p[0]) * a));
+    p[1] = static_cast<uint8_t>(std::lround(p[1] + (c.g - p[1]) * a));
+    p[2] = static_cast<uint8_t>(std::lround(p[2] + (c.b - p[2]) * a));
+  }
+
+  // Rectangle en coordonnées continues ; les bords partiels sont pondérés.
+  void fill(double x0, double y0, double x1, double y1, Rgb c, double a = 1.0) {
+    const int ix0 = std::max(0, int(std::floor(x0))), ix1 = std::min(w, int(std::ceil(x1)));
+    const int iy0 = std::max(0, int(std::floor(y0))), iy1 = std::min(h, int(std::ceil(y1)));
+    for (int y = iy0; y < iy1; ++y) {
+      const double cy = std::min<double>(y + 1, y1) - std::max<double>(y, y0);
+      for (int x = ix0; x < ix1; ++x) {
+        const double cx = std::min<double>(x + 1, x1) - std::max<double>(x, x0);
+        blend(x, y, c, a * cx * cy);
+      }
+    }
+  }
+
+  void cover(int x, int y, float v) {
+    float& m = mask[size_t(y) * w + x];
+    if (v > m) m = v;
+    mx0 = std::min(mx0, x); mx1 = std::max(mx1, x);
+    my0 = std::min(my0, y); my1 = std::max(my1, y);
+  }
+
+  void composite_mask(Rgb c) {
+    for (int y = my0; y <= my1; ++y) {
+      for (int x = mx0; x <= mx1; ++x) {
+        float& m = mask[size_t(y) * w + x];
+        if (m > 0) blend(x, y, c, m);
+        m = 0.f;
+      }
+    }
+    reset_mask_box();
+  }
+};
+
+struct Clip {
+  double x0, y0, x1, y1;
+};
+
+// Segment épais à bouts ronds dans le masque ; `dash0` = longueur déjà
+// parcourue sur la courbe (continuité des pointillés d'un segment à l'autre).
+void stroke_segment(Canvas& cv, double ax, double ay, double bx, double by, double half_w,
+                    bool dashed, double dash0, const Clip& clip) {
+  const double dx = bx - ax, dy = by - ay;
+  const double len2 = dx * dx + dy * dy;
+  const double len = std::sqrt(len2);
+  const double pad = half_w + 1;
+  const int x0 = std::max<int>(int(std::floor(std::min(ax, bx) - pad)), int(std::floor(clip.x0)));
+  const int x1 = std::min<int>(int(std::ceil(std::max(ax, bx) + pad)), int(std::ceil(clip.x1)) - 1);
+  const int y0 = std::max<int>(int(std::floor(std::min(ay, by) - pad)), int(std::floor(clip.y0)));
+  const int y1 = std::min<int>(int(std::ceil(std::max(ay, by) + pad)), int(std::ceil(clip.y1)) - 1);
+  for (int y = std::max(y0, 0); y <= std::min(y1, cv.h - 1); ++y) {
+    for (int x = std::max(x0, 0); x <= std::min(x1, cv.w - 1); ++x) {
+      const double cx = x + 0.5, cy = y + 0.5;
+      double t = len2 > 0 ? ((cx - ax) * dx + (cy - ay) * dy) / len2 : 0.0;
+      t = std::clamp(t, 0.0, 1.0);
+      const double ex = ax + t * dx - cx, ey = ay + t * dy - cy;
+      const double cov = std::clamp(half_w + 0.5 - std::sqrt(ex * ex + ey * ey), 0.0, 1.0);
+      if (cov <= 0) continue;
+      if (dashed && std::fmod(dash0 + t * len, DASH_ON + DASH_OFF) > DASH_ON) continue;
+      cv.cover(x, y, static_cast<float>(cov));
+    }
+  }
+}
+
+void stroke_marker(Canvas& cv, Marker m, double x, double y, const Clip& clip) {
+  if (m == Marker::Circle) {
+    stroke_segment(cv, x, y, x, y, MARKER_R, false, 0, clip);
+  } else if (m == Marker::Cross) {
+    const double k = MARKER_R;
+    stroke_segment(cv, x - k, y - k, x + k, y + k, 0.75, false, 0, clip);
+    stroke_segment(cv, x - k, y + k, x + k, y - k, 0.75, false, 0, clip);
+  }
+}
+
+// Polyligne + marqueurs d'une série, composée en une fois (pas de
+// surépaisseur aux jointures).
+void draw_polyline(Canvas& cv, const std::vector<std::pair<double, double>>& pts, const ChartSeries& s,
+                   const Clip& clip) {
+  const double half_w = s.width / 2;
+  double run = 0;
+  if (pts.size() == 1) stroke_segment(cv, pts[0].first, pts[0].second, pts[0].first, pts[0].second, half_w, false, 0, clip);
+  for (size_t i = 1; i < pts.size(); ++i) {
+    const auto [ax, ay] = pts[i - 1];
+    const auto [bx, by] = pts[i];
+    stroke_segment(cv, ax, ay, bx, by, half_w, s.dashed, run, clip);
+    run += std::hypot(bx - ax, by - ay);
+  }
+  for (const auto& [x, y] : pts) stroke_marker(cv, s.marker, x, y, clip);
+  cv.composite_mask(s.color);
+}
+
+// Texte bitmap ; (x, y) = coin haut gauche, ou bas gauche en vertical
+// (lecture de bas en haut).
+void draw_text(Canvas& cv, double x, double y, std::string_view text, Rgb c, bool vertical = false) {
+  const int ox = int(std::lround(x)), oy = int(std::lround(y));
+  int i = 0;
+  for (size_t k = 0; k < text.size(); ++k) {
+    unsigned char ch = static_cast<unsigned char>(text[k]);
+    if ((ch & 0xC0) == 0x80) continue; // suite UTF-8
+    if (ch < 32 || ch > 126) ch = '?';
+    const uint8_t* g = FONT5X7[ch - 32];
+    for (int col = 0; col < 5; ++col) {
+      for (int row = 0; row < 7; ++row) {
+        if (!(g[col] >> row & 1)) continue;
+        for (int sy = 0; sy < FONT_SCALE; ++sy) {
+          for (int sx = 0; sx < FONT_SCALE; ++sx) {
+            if (vertical) cv.blend(ox + row * FONT_SCALE + sx, oy - (i * 6 + col) * FONT_SCALE - sy - 1, c, 1.0);
+            else cv.blend(ox + (i * 6 + col) * FONT_SCALE + sx, oy + row * FONT_SCALE + sy, c, 1.0);
+          }
+        }
+      }
+    }
+    ++i;
+  }
+}
+
+std::vector<std::pair<double, double>> project(const Layout& L, const ChartSeries& s) {
+  std::vector<std::pair<double, double>> pts;
+  const size_t n = std::min(s.days.size(), s.values.size());
+  pts.reserve(n);
+  for (size_t i = 0; i < n; ++i) pts.emplace_back(L.px(s.days[i]), L.py(s.axis, s.values[i]));
+  return pts;
+}
+
+std::vector<uint8_t> rasterize(const Chart& c, const Layout& L) {
+  Canvas cv(c.width, c.height);
+  const Clip plot{L.l, L.t, L.r, L.b};
+  const Clip all{0, 0, double(c.width), double(c.height)};
+
+  for (const auto& t : L.yticks[0]) cv.fill(L.l, t.pos - 0.5, L.r, t.pos + 0.5, GRID);
+  for (const auto& band : c.bands) {
+    const int a = c.dual_axis ? band.axis : 0;
+    const double top = std::max(L.t, L.py(a, band.hi)), bottom = std::min(L.b, L.py(a, band.lo));
+    if (bottom > top) cv.fill(L.l, top, L.r, bottom, band.color, band.alpha);
+  }
+  for (const auto& s : c.series) draw_polyline(cv, project(L, s), s, plot);
+
+  // cadre, graduations, libellés
+  cv.fill(L.l - 0.5, L.t - 0.5, L.r + 0.5, L.t + 0.5, BLACK);
+  cv.fill(L.l - 0.5, L.b - 0.5, L.r + 0.5, L.b + 0.5, BLACK);
+  cv.fill(L.l - 0.5, L.t - 0.5, L.l + 0.5, L.b + 0.5, BLACK);
+  cv.fill(L.r - 0.5, L.t - 0.5, L.r + 0.5, L.b + 0.5, BLACK);
+  for (const auto& t : L.xticks) {
+    cv.fill(t.pos - 0.5, L.b, t.pos + 0.5, L.b + 5, BLACK);
+    draw_text(cv, t.pos - text_width(t.label) / 2, L.b + 5 + 8, t.label, BLACK);
+  }
+  double label_x[2] = {12, double(c.width) - 12 - CHAR_H};
+  for (int a = 0; a < (c.dual_axis ? 2 : 1); ++a) {
+    for (const auto& t : L.yticks[a]) {
+      if (a == 0) {
+        cv.fill(L.l - 5, t.pos - 0.5, L.l, t.pos + 0.5, BLACK);
+        draw_text(cv, L.l - 5 - 8 - text_width(t.label), t.pos - CHAR_H / 2.0, t.label, BLACK);
+      } else {
+        cv.fill(L.r, t.pos - 0.5, L.r + 5, t.pos + 0.5, BLACK);
+        draw_text(cv, L.r + 5 + 8, t.pos - CHAR_H / 2.0, t.label, BLACK);
+      }
+    }
+    if (!c.y[a].label.empty()) {
+      draw_text(cv, label_x[a], (L.t + L.b) / 2 + text_width(c.y[a].label) / 2, c.y[a].label, BLACK, true);
+    }
+  }
+  if (!c.title.empty()) draw_text(cv, (L.l + L.r - text_width(c.title)) / 2, L.title_y, c.title, BLACK);
+  if (!c.x_label.empty()) draw_text(cv, (L.l + L.r - text_width(c.x_label)) / 2, L.xlabel_y, c.x_label, BLACK);
+
+  if (c.legend) {
+    double x = (c.width - legend_width(c)) / 2;
+    const double mid = L.legend_y + CHAR_H / 2.0;
+    for (const auto& s : c.series) {
+      stroke_segment(cv, x, mid, x + LEGEND_SAMPLE, mid, s.width / 2, s.dashed, 0, all);
+      stroke_marker(cv, s.marker, x + LEGEND_SAMPLE / 2, mid, all);
+      cv.composite_mask(s.color);
+      draw_text(cv, x + LEGEND_SAMPLE + LEGEND_GAP, L.legend_y, s.label, BLACK);
+      x += LEGEND_SAMPLE + LEGEND_GAP + text_width(s.label) + LEGEND_SPACING;
+    }
+  }
+  return std::move(cv.rgb);
+}
+
+// --- PNG : encodage (zlib, un bloc deflate à codes de Huffman fixes) ---
+
+uint32_t crc32(const uint8_t* p, size_t n, uint32_t crc = 0) {
+  static const auto table = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+  crc = ~crc;
+  for (size_t i = 0; i < n; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+uint32_t adler32(const std::vector<uint8_t>& d) {
+  uint32_t a = 1, b = 0;
+  for (size_t i = 0; i < d.size();) {
+    const size_t end = std::min(d.size(), i + 5552); // pas de débordement avant le modulo
+    for (; i < end; ++i) { a += d[i]; b += a; }
+    a %= 65521;
+    b %= 65521;
+  }
+  return (b << 16) | a;
+}
+
+class BitWriter {
+public:
+  std::vector<uint8_t> out;
+
+  void bits(uint32_t v, int n) { // bits de poids faible d'abord
+    acc_ |= uint64_t(v) << nacc_;
+    nacc_ += n;
+    while (nacc_ >= 8) { out.push_back(uint8_t(acc_)); acc_ >>= 8; nacc_ -= 8; }
+  }
+  void code(uint32_t c, int n) { // codes de Huffman : bit de poids fort d'abord
+    uint32_t r = 0;
+    for (int i = 0; i < n; ++i) r |= ((c >> i) & 1) << (n - 1 - i);
+    bits(r, n);
+  }
+  void flush() { if (nacc_ > 0) bits(0, 8 - nacc_); }
+
+private:
+  uint64_t acc_ = 0;
+  int nacc_ = 0;
+};
+
+void put_literal(BitWriter& bw, int sym) {
+  if (sym < 144) bw.code(0x30 + sym, 8);
+  else if (sym < 256) bw.code(0x190 + sym - 144, 9);
+  else if (sym < 280) bw.code(sym - 256, 7);
+  else bw.code(0xC0 + sym - 280, 8);
+}
+
+void put_match(BitWriter& bw, int len, int dist) {
+  static constexpr int LEN_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                       35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+  static constexpr int LEN_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+  static constexpr int DIST_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                        8193, 12289, 16385, 24577};
+  static constexpr int DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                         7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+  int li = 28;
+  while (LEN_BASE[li] > len) --li;
+  put_literal(bw, 257 + li);
+  bw.bits(len - LEN_BASE[li], LEN_EXTRA[li]);
+  int di = 29;
+  while (DIST_BASE[di] > dist) --di;
+  bw.code(di, 5);
+  bw.bits(dist - DIST_BASE[di], DIST_EXTRA[di]);
+}
+
+// Seules deux distances sont essayées : pixel précédent et ligne précédente,
+// ce qui suffit pour des aplats et des courbes fines.
+std::vector<uint8_t> zlib_compress(const std::vector<uint8_t>& d, size_t row_bytes) {
+  BitWriter bw;
+  bw.bits(0x78, 8);
+  bw.bits(0x01, 8);
+  bw.bits(1, 1); // dernier bloc
+  bw.bits(1, 2); // Huffman fixe
+  const size_t dists[2] = {3, row_bytes};
+  for (size_t i = 0; i < d.size();) {
+    size_t best_len = 0, best_dist = 0;
+    for (size_t dist : dists) {
+      if (dist > i || dist > 32768) continue;
+      size_t n = 0;
+      const size_t max = std::min<size_t>(258, d.size() - i);
+      while (n < max && d[i + n] == d[i + n - dist]) ++n;
+      if (n > best_len) { best_len = n; best_dist = dist; }
+    }
+    if (best_len >= 3) {
+      put_match(bw, int(best_len), int(best_dist));
+      i += best_len;
+    } else {
+      put_literal(bw, d[i++]);
+    }
+  }
+  put_literal(bw, 256);
+  bw.flush();
+  const uint32_t adler = adler32(d);
+  for (int s = 24; s >= 0; s -= 8) bw.out.push_back(uint8_t(adler >> s));
+  return std::move(bw.out);
+}
+
+void put_u32(std::string& o, uint32_t v) {
+  for (int s = 24; s >= 0; s -= 8) o += char(v >> s);
+}
+
+void put_chunk(std::string& o, const char* type, const uint8_t* data, size_t n) {
+  put_u32(o, static_cast<uint32_t>(n));
+  const size_t start = o.size();
+  o.append(type, 4);
+  o.append(reinterpret_cast<const char*>(data), n);
+  put_u32(o, crc32(reinterpret_cast<const uint8_t*>(o.data() + start), n + 4));
+}
+
+std::string encode_png(int w, int h, const std::vector<uint8_t>& rgb) {
+  const size_t row = size_t(w) * 3;
+  std::vector<uint8_t> raw;
+  raw.reserve((row + 1) * h);
+  for (int y = 0; y < h; ++y) {
+    raw.push_back(0); // filtre None
+    raw.insert(raw.end(), rgb.begin() + y * row, rgb.begin() + (y + 1) * row);
+  }
+  const auto idat = zlib_compress(raw, row + 1);
+
+  std::string o = "\x89PNG\r\n\x1a\n";
+  uint8_t ihdr[13] = {};
+  for (int i = 0; i < 4; ++i) {
+    ihdr[i] = uint8_t(uint32_t(w) >> (24 - 8 * i));
+    ihdr[4 + i] = uint8_t(uint32_t(h) >> (24 - 8 * i));
+  }
+  ihdr[8] = 8;  // bits par canal
+  ihdr[9] = 2;  // RGB
+  put_chunk(o, "IHDR", ihdr, sizeof(ihdr));
+  put_chunk(o, "IDAT", idat.data(), idat.size());
+  put_chunk(o, "IEND", nullptr, 0);
+  return o;
+}
+
+bool write_file(const std::string& path, const std::string& data) {
+  std::error_code ec;
+  const auto parent = std::filesystem::path(path).parent_path();
+  if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+  const std::string tmp = temp_path_for(path);
+  {
+    std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+    f.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!f) {
+      std::filesystem::remove(tmp, ec);
+      return false;
+    }
+  }
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) std::filesystem::remove(tmp, ec);
+  return !ec;
+}
+
+} // namespace
+
+uint64_t chart_fingerprint(const Chart& c) {
+  PROFILE_ZONE("chart/fingerprint");
+  Fingerprint fp;
+  fp.add(uint64_t{CHART_RENDERER_VERSION});
+  fp.add(c.title).add(c.x_label);
+  for (const auto& axis : c.y) fp.add(axis.label).add(axis.min).add(axis.max);
+  fp.add(uint64_t{c.dual_axis}).add(uint64_t{c.legend});
+  fp.add(uint64_t(c.width)).add(uint64_t(c.height));
+  for (const auto& b : c.bands) {
+    fp.add(b.lo).add(b.hi).add(b.alpha).add(uint64_t(b.axis));
+    fp.add(uint64_t(b.color.r) << 16 | b.color.g << 8 | b.color.b);
+  }
+  for (const auto& s : c.series) {
+    fp.add(s.label).add(uint64_t(s.axis)).add(uint64_t{s.dashed}).add(uint64_t(s.marker)).add(s.width);
+    fp.add(uint64_t(s.color.r) << 16 | s.color.g << 8 | s.color.b);
+    fp.add(std::string_view(reinterpret_cast<const char*>(s.days.data()), s.days.size() * sizeof(int32_t)));
+    fp.add(std::string_view(reinterpret_cast<const char*>(s.values.data()), s.values.size() * sizeof(double)));
+  }
+  return fp.value();
+}
+
+bool chart_has_data(const Chart& chart) {
+  return std::any_of(chart.series.begin(), chart.series.end(),
+                     [](const ChartSeries& s) { return !s.days.empty() && !s.values.empty(); });
+}
+
+std::string render_chart_svg(const Chart& c) {
+  const Layout L = make_layout(c);
+  std::string o;
+  o += "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" + std::to_string(c.width) + "\" height=\"" +
+       std::to_string(c.height) + "\" viewBox=\"0 0 " + std::to_string(c.width) + " " +
+       std::to_string(c.height) + "\" font-family=\"sans-serif\" font-size=\"14\">\n";
+  o += "<defs><clipPath id=\"plot\"><rect x=\"" + num(L.l) + "\" y=\"" + num(L.t) + "\" width=\"" +
+       num(L.r - L.l) + "\" height=\"" + num(L.b - L.t) + "\"/></clipPath></defs>\n";
+  o += "<rect width=\"100%\" height=\"100%\" fill=\"#ffffff\"/>\n";
+
+  for (const auto& t : L.yticks[0]) {
+    o += "<line x1=\"" + num(L.l) + "\" y1=\"" + num(t.pos) + "\" x2=\"" + num(L.r) + "\" y2=\"" + num(t.pos) +
+         "\" stroke=\"" + hex(GRID) + "\"/>\n";
+  }
+  for (const auto& band : c.bands) {
+    const int a = c.dual_axis ? band.axis : 0;
+    const double top = std::max(L.t, L.py(a, band.hi)), bottom = std::min(L.b, L.py(a, band.lo));
+    if (bottom <= top) continue;
+    o += "<rect x=\"" + num(L.l) + "\" y=\"" + num(top) + "\" width=\"" + num(L.r - L.l) + "\" height=\"" +
+         num(bottom - top) + "\" fill=\"" + hex(band.color) + "\" fill-opacity=\"" + opacity(band.alpha) + "\"/>\n";
+  }
+
+  o += "<g clip-path=\"url(#plot)\">\n";
+  for (const auto& s : c.series) {
+    const auto pts = project(L, s);
+    o += "<polyline";
+    svg_stroke_attrs(o, s);
+    o += " points=\"";
+    for (const auto& [x, y] : pts) o += num(x) + "," + num(y) + " ";
+    o += "\"/>\n";
+    for (const auto& [x, y] : pts) svg_marker(o, s.marker, x, y, s.color);
+  }
+  o += "</g>\n";
+
+  o += "<rect x=\"" + num(L.l) + "\" y=\"" + num(L.t) + "\" width=\"" + num(L.r - L.l) + "\" height=\"" +
+       num(L.b - L.t) + "\" fill=\"none\" stroke=\"#000000\"/>\n";
+  for (const auto& t : L.xticks) {
+    o += "<line x1=\"" + num(t.pos) + "\" y1=\"" + num(L.b) + "\" x2=\"" + num(t.pos) + "\" y2=\"" +
+         num(L.b + 5) + "\" stroke=\"#000000\"/>\n";
+    svg_text(o, t.pos, L.b + 5 + 8 + CHAR_H, t.label, "middle");
+  }
+  for (int a = 0; a < (c.dual_axis ? 2 : 1); ++a) {
+    const double x = a == 0 ? L.l : L.r;
+    const double dir = a == 0 ? -1 : 1;
+    for (const auto& t : L.yticks[a]) {
+      o += "<line x1=\"" + num(x) + "\" y1=\"" + num(t.pos) + "\" x2=\"" + num(x + dir * 5) + "\" y2=\"" +
+           num(t.pos) + "\" stroke=\"#000000\"/>\n";
+      svg_text(o, x + dir * 13, t.pos + CHAR_H / 2.0, t.label, a == 0 ? "end" : "start");
+    }
+    if (!c.y[a].label.empty()) {
+      const double lx = a == 0 ? 12 + CHAR_H : c.width - 12;
+      svg_text(o, lx, (L.t + L.b) / 2, c.y[a].label, "middle", true);
+    }
+  }
+  if (!c.title.empty()) svg_text(o, (L.l + L.r) / 2, L.title_y + CHAR_H, c.title, "middle");
+  if (!c.x_label.empty()) svg_text(o, (L.l + L.r) / 2, L.xlabel_y + CHAR_H, c.x_label, "middle");
+
+  if (c.legend) {
+    double x = (c.width - legend_width(c)) / 2;
+    const double mid = L.legend_y + CHAR_H / 2.0;
+    for (const auto& s : c.series) {
+      o += "<line x1=\"" + num(x) + "\" y1=\"" + num(mid) + "\" x2=\"" + num(x + LEGEND_SAMPLE) + "\" y2=\"" +
+           num(mid) + "\"";
+      svg_stroke_attrs(o, s);
+      o += "/>\n";
+      svg_marker(o, s.marker, x + LEGEND_SAMPLE / 2, mid, s.color);
+      svg_text(o, x + LEGEND_SAMPLE + LEGEND_GAP, L.legend_y + CHAR_H, s.label, "start");
+      x += LEGEND_SAMPLE + LEGEND_GAP + text_width(s.label) + LEGEND_SPACING;
+    }
+  }
+  o += "</svg>\n";
+  return o;
+}
+
+bool write_chart_svg(const Chart& chart, const std::string& path) {
+  PROFILE_ZONE("chart/svg");
+  return write_file(path, render_chart_svg(chart));
+}
+
+bool write_chart_png(const Chart& chart, const std::string& path) {
+  PROFILE_ZONE("chart/png");
+  const Layout L = make_layout(chart);
+  return write_file(path, encode_png(chart.width, chart.height, rasterize(chart, L)));
+}
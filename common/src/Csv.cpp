@@ -0,0 +1,411 @@
+#include "Csv.hpp"
+#include "Date.hpp"
+#include "Profile.hpp"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::string trim(std::string s) {
+  auto not_space = [](unsigned char c){ return !std::isspace(c); };
+  s.erase(s.begin(), std::find_if(s.begin(), s.end(), not_space));
+  s.erase(std::find_if(s.rbegin(), s.rend(), not_space).base(), s.end());
+  return s;
+}
+
+std::string_view trim_view(std::string_view s) {
+  size_t a = 0, b = s.size();
+  while (a < b && std::isspace(static_cast<unsigned char>(s[a]))) ++a;
+  while (b > a && std::isspace(static_cast<unsigned char>(s[b - 1]))) --b;
+  return s.substr(a, b - a);
+}
+
+std::vector<std::string> split_csv_simple(const std::string& line) {
+  std::vector<std::string_view> fields;
+  std::string scratch;
+  split_csv_fields(line, fields, scratch);
+  return {fields.begin(), fields.end()};
+}
+
+std::vector<std::string> read_lines(const std::string& path) {
+  std::ifstream f(path);
+  std::vector<std::string> lines;
+  if (!f) return lines;
+  std::string line;
+  while (std::getline(f, line)) {
+    line = trim(line);
+    if (!line.empty()) lines.push_back(line);
+  }
+  return lines;
+}
+
+void append_line(const std::string& path, const std::string& line) {
+  AppendBatch batch(path);
+  batch.add(line);
+  batch.commit();
+}
+
+// --- AppendBatch ---
+
+AppendBatch::AppendBatch(std::string path, bool durable) : path_(std::move(path)), durable_(durable) {}
+
+void AppendBatch::add(std::string_view line) {
+  buf_ += line;
+  buf_ += '\n';
+  ++lines_;
+}
+
+static bool write_all(int fd, std::string_view data) {
+  while (!data.empty()) {
+    const ssize_t n = ::write(fd, data.data(), data.size());
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data.remove_prefix(static_cast<size_t>(n));
+  }
+  return true;
+}
+
+// Fichier neuf : contenu complet écrit à côté puis renommé.
+static bool create_file_atomic(const std::string& path, std::string_view data, bool durable) {
+  const std::string tmp = temp_path_for(path);
+  const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) return false;
+  bool ok = write_all(fd, data) && (!durable || ::fsync(fd) == 0);
+  ok = (::close(fd) == 0) && ok;
+  if (ok) ok = ::rename(tmp.c_str(), path.c_str()) == 0;
+  if (!ok) {
+    ::unlink(tmp.c_str());
+    return false;
+  }
+  if (durable) {
+    // le rename lui-même doit survivre à une coupure
+    const auto parent = std::filesystem::path(path).parent_path();
+    const int dfd = ::open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd >= 0) {
+      ::fsync(dfd);
+      ::close(dfd);
+    }
+  }
+  return true;
+}
+
+bool AppendBatch::commit() {
+  if (lines_ == 0) return true;
+  std::string data;
+  data.swap(buf_);
+  lines_ = 0;
+
+  // Assure que le dossier parent existe (utile si path = ".../data/batches.csv")
+  const auto parent = std::filesystem::path(path_).parent_path();
+  if (!parent.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(parent, ec);
+  }
+
+  const int fd = ::open(path_.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+  if (fd < 0) return errno == ENOENT && create_file_atomic(path_, data, durable_);
+
+  struct stat st{};
+  bool ok = ::fstat(fd, &st) == 0;
+  const off_t size = ok ? st.st_size : 0;
+  if (ok && size > 0) {
+    char last = '\0';
+    ok = ::pread(fd, &last, 1, size - 1) == 1;
+    if (ok && last != '\n') data.insert(data.begin(), '\n');
+  }
+  if (ok) ok = write_all(fd, data) && (!durable_ || ::fdatasync(fd) == 0);
+  if (!ok) {
+    // rien de partiel ne reste dans le fichier
+    const int rc = ::ftruncate(fd, size);
+    (void)rc;
+  }
+  ::close(fd);
+  return ok;
+}
+
+std::string temp_path_for(const std::string& path) {
+  static std::atomic<unsigned> counter{0};
+  return path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter.fetch_add(1));
+}
+
+bool file_exists(const std::string& path) {
+  return std::filesystem::exists(path);
+}
+
+std::string csv_escape(std::string_view field) {
+  std::string out;
+  append_csv_field(out, field);
+  return out;
+}
+
+void append_csv_field(std::string& out, std::string_view field) {
+  const bool needs_quotes =
+    field.find_first_of(",\"\n\r") != std::string_view::npos ||
+    trim_view(field).size() != field.size();
+  if (!needs_quotes) {
+    out += field;
+    return;
+  }
+
+  out += '"';
+  for (char c : field) {
+    if (c == '"') out += '"';
+    out += (c == '\n' || c == '\r') ? ' ' : c; // un enregistrement tient sur une ligne
+  }
+  out += '"';
+}
+
+bool parse_double(std::string_view s, double& out) {
+  if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+  const auto* end = s.data() + s.size();
+  double v = 0.0;
+  auto res = std::from_chars(s.data(), end, v);
+  if (res.ec != std::errc{} || res.ptr != end || !std::isfinite(v)) return false;
+  out = v;
+  return true;
+}
+
+bool parse_int(std::string_view s, int& out) {
+  if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+  const auto* end = s.data() + s.size();
+  auto res = std::from_chars(s.data(), end, out);
+  return res.ec == std::errc{} && res.ptr == end;
+}
+
+void append_double(std::string& out, double v) {
+  char buf[32]; // plus longue écriture : -2.2250738585072014e-308
+  const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+  out.append(buf, res.ptr);
+}
+
+void append_int(std::string& out, long long v) {
+  char buf[24];
+  const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+  out.append(buf, res.ptr);
+}
+
+std::string format_double(double v) {
+  std::string out;
+  append_double(out, v);
+  return out;
+}
+
+// --- MappedFile ---
+
+MappedFile::MappedFile(const std::string& path, Access access) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return;
+  struct stat st{};
+  if (::fstat(fd, &st) == 0) {
+    open_ = true;
+    if (st.st_size > 0) {
+      void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        addr_ = p;
+        size_ = static_cast<size_t>(st.st_size);
+        ::madvise(addr_, size_, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        PROFILE_COUNT("bytes mapped", size_);
+      } else {
+        open_ = false;
+      }
+    }
+  }
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (addr_) ::munmap(addr_, size_);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+  : addr_(other.addr_), size_(other.size_), open_(other.open_) {
+  other.addr_ = nullptr;
+  other.size_ = 0;
+  other.open_ = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    if (addr_) ::munmap(addr_, size_);
+    addr_ = other.addr_;
+    size_ = other.size_;
+    open_ = other.open_;
+    other.addr_ = nullptr;
+    other.size_ = 0;
+    other.open_ = false;
+  }
+  return *this;
+}
+
+// --- découpage ---
+
+bool split_csv_fields(std::string_view line, std::vector<std::string_view>& out,
+                      std::string& scratch, char sep) {
+  out.clear();
+  scratch.clear();
+  scratch.reserve(line.size()); // les vues dans scratch ne doivent pas être invalidées
+
+  const size_t n = line.size();
+  size_t i = 0;
+  bool closed = true;
+  while (true) {
+    size_t j = i;
+    while (j < n && line[j] != sep && (line[j] == ' ' || line[j] == '\t')) ++j;
+
+    if (j < n && line[j] == '"') {
+      size_t k = j + 1;
+      bool escaped = false;
+      while (k < n) {
+        if (line[k] == '"') {
+          if (k + 1 < n && line[k + 1] == '"') { escaped = true; k += 2; continue; }
+          break;
+        }
+        ++k;
+      }
+      if (k >= n) closed = false;
+      std::string_view raw = line.substr(j + 1, k - (j + 1));
+      if (escaped) {
+        const size_t pos = scratch.size();
+        for (size_t r = 0; r < raw.size(); ++r) {
+          scratch += raw[r];
+          if (raw[r] == '"') ++r; // "" -> "
+        }
+        out.emplace_back(scratch.data() + pos, scratch.size() - pos);
+      } else {
+        out.push_back(raw);
+      }
+      const size_t s = line.find(sep, std::min(k + 1, n));
+      if (s == std::string_view::npos) return closed;
+      i = s + 1;
+      continue;
+    }
+
+    const size_t s = line.find(sep, i);
+    out.push_back(trim_view(line.substr(i, s == std::string_view::npos ? std::string_view::npos : s - i)));
+    if (s == std::string_view::npos) return closed;
+    i = s + 1;
+  }
+}
+
+// Fin (position du '\n', ou text.size()) de l'enregistrement commençant à
+// `pos`. Seule règle de découpage, partagée par CsvReader, les blocs et les
+// tranches : un guillemet n'ouvre un champ qu'en début de champ et ne
+// protège que le séparateur, un enregistrement est donc une ligne physique.
+static size_t record_end(std::string_view text, size_t pos) {
+  const size_t nl = text.find('\n', pos);
+  return nl == std::string_view::npos ? text.size() : nl;
+}
+
+size_t complete_records_prefix(std::string_view text) {
+  const size_t nl = text.rfind('\n'); // fin du dernier enregistrement complet
+  return nl == std::string_view::npos ? 0 : nl + 1;
+}
+
+std::vector<std::string_view> split_record_ranges(std::string_view text, size_t parts) {
+  std::vector<std::string_view> out;
+  if (text.empty()) return out;
+  if (parts <= 1) { out.push_back(text); return out; }
+
+  const size_t step = text.size() / parts + 1;
+  size_t begin = 0;
+  while (begin < text.size()) {
+    // coupe après l'enregistrement qui contient begin + step - 1
+    const size_t cut = std::min(begin + step, text.size()) - 1;
+    const size_t end = std::min(record_end(text, cut) + 1, text.size());
+    out.push_back(text.substr(begin, end - begin));
+    begin = end;
+  }
+  return out;
+}
+
+// --- Parse parallèle ---
+
+static std::atomic<unsigned> g_parse_threads{0}; // 0 = pas encore résolu
+
+static unsigned hardware_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+unsigned parse_threads() {
+  unsigned n = g_parse_threads.load(std::memory_order_relaxed);
+  if (n != 0) return n;
+  n = hardware_threads();
+  if (const char* env = std::getenv("DAILYAPP_PARSE_THREADS")) {
+    int v = 0;
+    if (parse_int(env, v) && v > 0) n = static_cast<unsigned>(v);
+  }
+  g_parse_threads.store(n, std::memory_order_relaxed);
+  return n;
+}
+
+void set_parse_threads(unsigned n) {
+  g_parse_threads.store(n ? n : hardware_threads(), std::memory_order_relaxed);
+}
+
+std::vector<std::string_view> parse_ranges(std::string_view body, size_t min_bytes) {
+  const unsigned threads = parse_threads();
+  if (threads <= 1 || body.size() < min_bytes) return {body};
+  return split_record_ranges(body, threads);
+}
+
+// --- CsvReader ---
+
+CsvReader::CsvReader(const std::string& path, char sep)
+  : file_(path), rest_(file_.data()), ok_(file_.is_open()), sep_(sep) {}
+
+CsvReader CsvReader::from_text(std::string_view text, char sep) {
+  CsvReader r(std::string{}, sep);
+  r.rest_ = text;
+  r.ok_ = true;
+  return r;
+}
+
+bool CsvReader::next(std::span<const std::string_view>& row) {
+  while (!rest_.empty()) {
+    ++line_;
+    // un enregistrement = une ligne physique : un guillemet isolé (pizza 12")
+    // ou un champ coupé ("midi, soi) n'emporte pas les lignes suivantes
+    const size_t end = record_end(rest_, 0);
+    std::string_view line = rest_.substr(0, end);
+    rest_ = rest_.substr(std::min(end + 1, rest_.size()));
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (trim_view(line).empty()) continue;
+
+    record_ = line;
+    open_quote_ = !split_csv_fields(line, fields_, scratch_, sep_);
+    row = fields_;
+    return true;
+  }
+  return false;
+}
+
+std::optional<size_t> seek_date_sorted(std::string_view text, size_t begin, const Date& from) {
+  size_t lo = begin, hi = text.size();
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    // ligne contenant mid ; lo étant un début de ligne, start ∈ [lo, mid]
+    const size_t nl = text.rfind('\n', mid == 0 ? 0 : mid - 1);
+    const size_t start = (nl == std::string_view::npos || nl < lo) ? lo : nl + 1;
+    size_t end = text.find('\n', start);
+    if (end == std::string_view::npos || end > hi) end = hi;
+
+    Date d{};
+    if (!parse_date_yyyy_mm_dd(trim_view(text.substr(start, std::min<size_t>(10, end - start))), d)) return std::nullopt;
+    if (d < from) lo = end + 1;
+    else hi = start;
+  }
+  return std::min(lo, text.size());
+}
@@ -0,0 +1,80 @@
+#include "Date.hpp"
+
+#include <charconv>
+#include <ctime>
+
+static_assert(make_date(1970, 1, 1).serial == 0);
+static_assert(make_date(2000, 3, 1).serial == 11017);
+static_assert(to_ymd(make_date(2024, 2, 29)).d == 29);
+static_assert(weekday(make_date(2026, 1, 19)) == 0); // lundi
+static_assert(days_between_inclusive(make_date(2025, 12, 30), make_date(2026, 1, 2)) == 4);
+
+static bool read_digits(std::string_view s, int& out) {
+  int v = 0;
+  for (char c : s) {
+    if (c < '0' || c > '9') return false;
+    v = v * 10 + (c - '0');
+  }
+  out = v;
+  return true;
+}
+
+bool parse_date_yyyy_mm_dd(std::string_view s, Date& out) {
+  // format strict YYYY-MM-DD
+  if (s.size() != 10 || s[4] != '-' || s[7] != '-') return false;
+  int y = 0, m = 0, d = 0;
+  if (!read_digits(s.substr(0, 4), y)) return false;
+  if (!read_digits(s.substr(5, 2), m)) return false;
+  if (!read_digits(s.substr(8, 2), d)) return false;
+  if (!is_valid_ymd(y, m, d)) return false;
+  out = make_date(y, m, d);
+  return true;
+}
+
+void format_date_to(const Date& dt, char* out) {
+  const Ymd c = to_ymd(dt);
+  const int y = c.y < 0 ? 0 : (c.y > 9999 ? 9999 : c.y);
+  out[0] = char('0' + y / 1000);
+  out[1] = char('0' + y / 100 % 10);
+  out[2] = char('0' + y / 10 % 10);
+  out[3] = char('0' + y % 10);
+  out[4] = '-';
+  out[5] = char('0' + c.m / 10);
+  out[6] = char('0' + c.m % 10);
+  out[7] = '-';
+  out[8] = char('0' + c.d / 10);
+  out[9] = char('0' + c.d % 10);
+}
+
+std::string format_date(const Date& dt) {
+  std::string s(10, '0');
+  format_date_to(dt, s.data());
+  return s;
+}
+
+Date today_local() {
+  const std::time_t now = std::time(nullptr);
+  std::tm tm{};
+  localtime_r(&now, &tm);
+  return make_date(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+}
+
+RangeArg parse_range_arg(std::span<const std::string_view> args, size_t& i, DateRange& range) {
+  const std::string_view opt = args[i];
+  if (opt != "--from" && opt != "--to" && opt != "--last") return RangeArg::None;
+  if (i + 1 >= args.size()) return RangeArg::Invalid;
+  const std::string_view val = args[++i];
+
+  if (opt == "--last") {
+    int n = 0;
+    const auto res = std::from_chars(val.data(), val.data() + val.size(), n);
+    if (res.ec != std::errc{} || res.ptr != val.data() + val.size() || n < 1) return RangeArg::Invalid;
+    range.to = today_local();
+    range.from = add_days(range.to, -(n - 1));
+    return RangeArg::Ok;
+  }
+  Date d{};
+  if (!parse_date_yyyy_mm_dd(val, d)) return RangeArg::Invalid;
+  (opt == "--from" ? range.from : range.to) = d;
+  return RangeArg::Ok;
+}
@@ -0,0 +1,237 @@
+#include "PlotCache.hpp"
+#include "Csv.hpp"
+#include "Profile.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+uint64_t mix(uint64_t h) { // splitmix64
+  h += 0x9E3779B97F4A7C15ull;
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+  return h ^ (h >> 31);
+}
+
+std::string key_line(uint64_t key) {
+  char buf[24];
+  std::snprintf(buf, sizeof(buf), "%016llx\n", static_cast<unsigned long long>(key));
+  return buf;
+}
+
+// Verrou exclusif tenu pendant la durée de vie de l'objet (aucun si le
+// fichier de verrou ne peut être créé : le cache reste correct, au pire
+// deux rendus identiques).
+class FileLock {
+public:
+  explicit FileLock(const std::string& path)
+      : fd_(::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)) {
+    if (fd_ >= 0) {
+      while (::flock(fd_, LOCK_EX) != 0 && errno == EINTR) {}
+    }
+  }
+  ~FileLock() {
+    if (fd_ >= 0) ::close(fd_); // libère le flock
+  }
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+
+private:
+  int fd_;
+};
+
+PlotWorker g_worker = PlotWorker::Process;
+std::atomic<int> g_active_threads{0};
+
+std::string read_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// Fichier temporaire puis rename : un lecteur voit l'ancien ou le nouveau.
+bool write_atomic(const std::string& path, const std::string& content) {
+  std::error_code ec;
+  const std::string tmp = temp_path_for(path);
+  {
+    std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+    f << content;
+    if (!f) {
+      std::filesystem::remove(tmp, ec);
+      return false;
+    }
+  }
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) std::filesystem::remove(tmp, ec);
+  return !ec;
+}
+
+void write_state(const std::string& sidecar, const char* state, uint64_t key, std::string_view message = {}) {
+  std::string body = "state=";
+  body += state;
+  body += "\nkey=" + key_line(key);
+  body += "updated=" + std::to_string(static_cast<long long>(std::time(nullptr))) + "\n";
+  if (!message.empty()) {
+    body += "message=";
+    body += message.substr(0, message.find('\n'));
+    body += '\n';
+  }
+  write_atomic(sidecar + ".status", body);
+}
+
+bool cache_valid(const PlotJob& job) {
+  for (const auto& out : job.outputs) {
+    if (!file_exists(out)) return false;
+  }
+  return read_file(job.sidecar) == key_line(job.key);
+}
+
+// Vérification + rendu + enregistrement de la clé, sous verrou.
+PlotStatus render_job(const PlotJob& job, std::ostream& err, bool skip_if_superseded) {
+  PROFILE_ZONE("plot/render job");
+  std::error_code ec;
+  const auto parent = std::filesystem::path(job.sidecar).parent_path();
+  if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+
+  FileLock lock(job.sidecar + ".lock");
+  if (cache_valid(job)) {
+    PlotState st;
+    if (!read_plot_state(job.sidecar, st) || st.state != "done" || st.key != job.key)
+      write_state(job.sidecar, "done", job.key);
+    return PlotStatus::Hit;
+  }
+  // une demande plus récente est en file : son worker rendra à notre place
+  if (skip_if_superseded && read_file(job.sidecar + ".request") != key_line(job.key)) return PlotStatus::Queued;
+
+  write_state(job.sidecar, "running", job.key);
+  // clé retirée d'abord : un rendu interrompu ne laisse jamais une clé
+  // valide à côté de sorties partielles
+  std::filesystem::remove(job.sidecar, ec);
+
+  std::ostringstream messages;
+  const bool ok = job.render(messages);
+  err << messages.str();
+  if (!ok) {
+    write_state(job.sidecar, "failed", job.key, messages.str());
+    return PlotStatus::Failed;
+  }
+  write_atomic(job.sidecar, key_line(job.key));
+  write_state(job.sidecar, "done", job.key);
+  return PlotStatus::Rendered;
+}
+
+} // namespace
+
+Fingerprint& Fingerprint::add(uint64_t v) {
+  h_ = mix(h_ ^ v);
+  return *this;
+}
+
+Fingerprint& Fingerprint::add(double v) {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return add(bits);
+}
+
+Fingerprint& Fingerprint::add(std::string_view bytes) {
+  add(static_cast<uint64_t>(bytes.size()));
+  size_t i = 0;
+  for (; i + 8 <= bytes.size(); i += 8) {
+    uint64_t w = 0;
+    std::memcpy(&w, bytes.data() + i, 8);
+    h_ = mix(h_ ^ w);
+  }
+  uint64_t tail = 0;
+  if (i < bytes.size()) std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+  return add(tail);
+}
+
+bool fingerprint_file(Fingerprint& fp, const std::string& path) {
+  if (!file_exists(path)) return false;
+  MappedFile file(path);
+  fp.add(file.data());
+  return true;
+}
+
+PlotStatus run_plot(const PlotJob& job, std::ostream& err) {
+  write_atomic(job.sidecar + ".request", key_line(job.key)); // les workers plus anciens s'effacent
+  return render_job(job, err, /*skip_if_superseded=*/false);
+}
+
+PlotStatus submit_plot(PlotJob job) {
+  if (cache_valid(job)) return PlotStatus::Hit;
+  write_atomic(job.sidecar + ".request", key_line(job.key));
+  write_state(job.sidecar, "pending", job.key);
+
+  if (g_worker == PlotWorker::Thread) {
+    g_active_threads.fetch_add(1);
+    std::thread([job = std::move(job)] {
+      std::ostringstream sink; // erreurs : dans le fichier d'état
+      render_job(job, sink, /*skip_if_superseded=*/true);
+      g_active_threads.fetch_sub(1);
+    }).detach();
+    return PlotStatus::Queued;
+  }
+
+  const pid_t pid = ::fork();
+  if (pid < 0) {
+    std::ostringstream sink;
+    return render_job(job, sink, false); // pas de worker : rendu sur place
+  }
+  if (pid == 0) {
+    // double fork : le worker n'est pas un enfant de la commande et ne garde
+    // ni le terminal ni les tubes (`DailyApp food history | less` rend la main)
+    ::setsid();
+    if (::fork() != 0) ::_exit(0);
+    const int null = ::open("/dev/null", O_RDWR);
+    if (null >= 0) {
+      for (int fd = 0; fd <= 2; ++fd) ::dup2(null, fd);
+      if (null > 2) ::close(null);
+    }
+    std::ostringstream sink;
+    render_job(job, sink, true);
+    ::_exit(0); // sans vider les tampons stdio hérités du parent
+  }
+  int status = 0;
+  while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+  return PlotStatus::Queued;
+}
+
+void set_plot_worker(PlotWorker worker) {
+  g_worker = worker;
+}
+
+void wait_plot_workers() {
+  while (g_active_threads.load() > 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
+
+bool read_plot_state(const std::string& sidecar, PlotState& state) {
+  std::ifstream in(sidecar + ".status");
+  if (!in) return false;
+  state = PlotState{};
+  std::string line;
+  while (std::getline(in, line)) {
+    const size_t eq = line.find('=');
+    if (eq == std::string::npos) continue;
+    const std::string_view k(line.data(), eq), v = std::string_view(line).substr(eq + 1);
+    if (k == "state") state.state = v;
+    else if (k == "key") state.key = std::strtoull(std::string(v).c_str(), nullptr, 16);
+    else if (k == "updated") state.updated = std::atoll(std::string(v).c_str());
+    else if (k == "message") state.message = v;
+  }
+  return !state.state.empty();
+}
@@ -0,0 +1,204 @@
+#include "Profile.hpp"
+#include "Csv.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace profile {
+namespace {
+
+struct ZoneStats {
+  uint64_t calls = 0;
+  uint64_t total_ns = 0, self_ns = 0, max_ns = 0;
+  uint64_t allocs = 0, alloc_bytes = 0;
+};
+
+struct Event {
+  const char* name;
+  uint32_t tid;
+  uint64_t start_ns, dur_ns;
+};
+
+struct CounterEvent {
+  const char* name;
+  uint64_t at_ns, value;
+};
+
+std::atomic<bool> g_active{false};
+bool g_trace = false;
+uint64_t g_origin_ns = 0;
+std::atomic<uint32_t> g_next_tid{0};
+
+std::mutex g_mutex; // protège tout ce qui suit
+std::map<std::string_view, ZoneStats> g_zones;
+std::map<std::string_view, uint64_t> g_counters;
+std::vector<Event> g_events;
+std::vector<CounterEvent> g_counter_events;
+
+thread_local Zone* t_current = nullptr;
+thread_local uint64_t t_allocs = 0, t_alloc_bytes = 0;
+thread_local uint32_t t_tid = g_next_tid.fetch_add(1);
+
+uint64_t now_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Compteurs de /proc/self/io (Linux) : appels read / write du processus.
+bool proc_io(uint64_t& syscr, uint64_t& syscw, uint64_t& rchar) {
+  std::ifstream in("/proc/self/io");
+  std::string key;
+  uint64_t v = 0;
+  int found = 0;
+  while (in >> key >> v) {
+    if (key == "syscr:") syscr = v, ++found;
+    else if (key == "syscw:") syscw = v, ++found;
+    else if (key == "rchar:") rchar = v, ++found;
+  }
+  return found == 3;
+}
+
+std::string json_string(std::string_view s) {
+  std::string out = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out + "\"";
+}
+
+} // namespace
+
+void start(bool trace) {
+  std::lock_guard lock(g_mutex);
+  g_trace = trace;
+  g_origin_ns = now_ns();
+  g_active.store(true, std::memory_order_release);
+}
+
+bool active() {
+  return g_active.load(std::memory_order_relaxed);
+}
+
+void count(const char* counter, uint64_t n) {
+  if (!active()) return;
+  std::lock_guard lock(g_mutex);
+  const uint64_t v = g_counters[counter] += n;
+  if (g_trace) g_counter_events.push_back({counter, now_ns() - g_origin_ns, v});
+}
+
+void note_alloc(size_t bytes) {
+  if (!active()) return;
+  ++t_allocs;
+  t_alloc_bytes += bytes;
+}
+
+Zone::Zone(const char* name) : name_(name) {
+  if (!active()) return;
+  on_ = true;
+  parent_ = t_current;
+  t_current = this;
+  allocs_ = t_allocs;
+  alloc_bytes_ = t_alloc_bytes;
+  start_ns_ = now_ns();
+}
+
+Zone::~Zone() {
+  if (!on_) return;
+  const uint64_t end = now_ns();
+  const uint64_t dur = end - start_ns_;
+  t_current = parent_;
+  if (parent_) parent_->child_ns_ += dur;
+
+  std::lock_guard lock(g_mutex);
+  ZoneStats& z = g_zones[name_];
+  ++z.calls;
+  z.total_ns += dur;
+  z.self_ns += dur > child_ns_ ? dur - child_ns_ : 0;
+  z.max_ns = std::max(z.max_ns, dur);
+  z.allocs += t_allocs - allocs_;
+  z.alloc_bytes += t_alloc_bytes - alloc_bytes_;
+  if (g_trace) g_events.push_back({name_, t_tid, start_ns_ - g_origin_ns, dur});
+}
+
+void report(std::ostream& out) {
+  std::lock_guard lock(g_mutex);
+  std::vector<std::pair<std::string_view, ZoneStats>> zones(g_zones.begin(), g_zones.end());
+  std::sort(zones.begin(), zones.end(), [](const auto& a, const auto& b) { return a.second.total_ns > b.second.total_ns; });
+
+  char line[256];
+  std::snprintf(line, sizeof(line), "\n%-34s %7s %11s %11s %11s %9s %11s\n", "zone", "appels", "total ms",
+                "propre ms", "max ms", "allocs", "Ko alloués");
+  out << line;
+  for (const auto& [name, z] : zones) {
+    std::snprintf(line, sizeof(line), "%-34.*s %7llu %11.3f %11.3f %11.3f %9llu %11.1f\n",
+                  static_cast<int>(name.size()), name.data(), static_cast<unsigned long long>(z.calls),
+                  z.total_ns / 1e6, z.self_ns / 1e6, z.max_ns / 1e6,
+                  static_cast<unsigned long long>(z.allocs), z.alloc_bytes / 1024.0);
+    out << line;
+  }
+  if (!g_counters.empty()) out << "\n";
+  for (const auto& [name, v] : g_counters) {
+    std::snprintf(line, sizeof(line), "%-34.*s %llu\n", static_cast<int>(name.size()), name.data(),
+                  static_cast<unsigned long long>(v));
+    out << line;
+  }
+
+  uint64_t syscr = 0, syscw = 0, rchar = 0;
+  if (proc_io(syscr, syscw, rchar)) {
+    std::snprintf(line, sizeof(line), "%-34s %llu read, %llu write (%llu octets lus)\n", "appels système",
+                  static_cast<unsigned long long>(syscr), static_cast<unsigned long long>(syscw),
+                  static_cast<unsigned long long>(rchar));
+    out << line;
+  }
+  rusage ru{};
+  if (::getrusage(RUSAGE_SELF, &ru) == 0) {
+    std::snprintf(line, sizeof(line), "%-34s %ld Ko\n", "mémoire max (RSS)", ru.ru_maxrss);
+    out << line;
+  }
+}
+
+bool write_trace(const std::string& path) {
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  char buf[128];
+  {
+    std::lock_guard lock(g_mutex);
+    bool first = true;
+    for (const Event& e : g_events) {
+      out += first ? "" : ",\n";
+      first = false;
+      out += "{\"name\":" + json_string(e.name) + ",\"ph\":\"X\",\"pid\":1";
+      std::snprintf(buf, sizeof(buf), ",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", e.tid, e.start_ns / 1e3, e.dur_ns / 1e3);
+      out += buf;
+    }
+    for (const CounterEvent& c : g_counter_events) {
+      out += first ? "" : ",\n";
+      first = false;
+      out += "{\"name\":" + json_string(c.name) + ",\"ph\":\"C\",\"pid\":1";
+      std::snprintf(buf, sizeof(buf), ",\"ts\":%.3f,\"args\":{\"value\":%llu}}", c.at_ns / 1e3,
+                    static_cast<unsigned long long>(c.value));
+      out += buf;
+    }
+  }
+  out += "\n]}\n";
+
+  const std::string tmp = temp_path_for(path);
+  {
+    std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+    f.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!f) return false;
+  }
+  return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+} // namespace profile
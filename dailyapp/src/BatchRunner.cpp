@@ -0,0 +1,120 @@
+#include "BatchRunner.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "FoodCli.hpp"
+#include "WeightCli.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Durée formatée à part : std::cout garde le format des sorties de commandes.
+std::string ms_since(Clock::time_point t0) {
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(2)
+      << std::chrono::duration<double, std::milli>(Clock::now() - t0).count() << " ms";
+    return s.str();
+}
+
+// Découpe sur les espaces ; "..." regroupe un argument. Faux si un
+// guillemet n'est pas refermé.
+bool split_command(const std::string& line, std::vector<std::string>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+        if (i == line.size()) break;
+        std::string tok;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+            if (line[i] == '"') {
+                const size_t close = line.find('"', i + 1);
+                if (close == std::string::npos) return false;
+                tok.append(line, i + 1, close - i - 1);
+                i = close + 1;
+            } else {
+                tok += line[i++];
+            }
+        }
+        out.push_back(std::move(tok));
+    }
+    return true;
+}
+
+} // namespace
+
+int run_batch(std::span<const std::string_view> args) {
+    if (args.size() != 1) {
+        std::cerr << "Usage: DailyApp batch <fichier|->\n";
+        return 2;
+    }
+
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (args[0] != "-") {
+        file.open(std::string(args[0]));
+        if (!file) {
+            std::cerr << "Fichier illisible: " << args[0] << "\n";
+            return 1;
+        }
+        in = &file;
+    }
+
+    const auto t0 = Clock::now();
+    food::Session food;
+    weight::Session weight;
+    food.defer_writes();
+    weight.storage.deferWrites();
+
+    size_t count = 0, failed = 0, line_no = 0;
+    std::string line;
+    std::vector<std::string> tokens;
+    std::vector<std::string_view> cmd;
+
+    while (std::getline(*in, line)) {
+        ++line_no;
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        ++count;
+        int rc = 0;
+        const auto t = Clock::now();
+        if (!split_command(line, tokens)) {
+            std::cerr << "Guillemet non fermé\n";
+            rc = 2;
+        } else {
+            cmd.assign(tokens.begin(), tokens.end());
+            const std::span<const std::string_view> sub(cmd.data() + 1, cmd.size() - 1);
+            if (cmd[0] == "food") {
+                rc = food::run(food, sub, std::cout, std::cerr);
+            } else if (cmd[0] == "weight") {
+                rc = weight::run(weight, sub, std::cout, std::cerr);
+            } else {
+                std::cerr << "Tracker inconnu: " << cmd[0] << " (weight ou food)\n";
+                rc = 2;
+            }
+        }
+        if (rc != 0) ++failed;
+        std::cout << "[" << line_no << "] " << (rc == 0 ? "ok" : "échec (" + std::to_string(rc) + ")")
+                  << ", " << ms_since(t) << " : " << line.substr(first) << "\n";
+    }
+
+    const auto t_flush = Clock::now();
+    int rc = food.flush_writes(std::cerr);
+    if (!weight.storage.commitWrites()) {
+        std::cerr << "Écriture de weight_history.log impossible.\n";
+        rc = 1;
+    }
+    const std::string flush_time = ms_since(t_flush);
+
+    std::cout << "batch: " << count << " commandes, " << failed << " échec(s), "
+              << ms_since(t0) << " (écriture finale " << flush_time << ")\n";
+    if (rc != 0) return rc;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <span>
+#include <string_view>
+
+// `DailyApp batch <fichier|->` : une commande `weight ...` / `food ...` par
+// ligne (lignes vides et commentaires `#` ignorés, "..." pour un argument
+// avec espaces), exécutées dans un seul processus. Les données sont chargées
+// une fois, les écritures gardées en mémoire puis écrites à la fin, avec une
+// seule mise à jour de food_history.csv. Les commandes qui lisent les
+// fichiers dérivés (food history / rebuild, weight history) écrivent d'abord
+// ce qui est en attente.
+int run_batch(std::span<const std::string_view> args);
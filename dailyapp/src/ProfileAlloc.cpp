@@ -0,0 +1,35 @@
+// Allocations comptées par zone pour DailyApp --profile : operator new
+// remplacé seulement quand les zones sont compilées.
+#ifdef DAILYAPP_PROFILING
+
+#include <cstdlib>
+#include <new>
+
+#include "Profile.hpp"
+
+namespace {
+void* profiled_alloc(std::size_t n) {
+    profile::note_alloc(n);
+    return std::malloc(n ? n : 1);
+}
+} // namespace
+
+void* operator new(std::size_t n) {
+    if (void* p = profiled_alloc(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {
+    if (void* p = profiled_alloc(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return profiled_alloc(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return profiled_alloc(n); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif
@@ -0,0 +1,267 @@
+#include "Server.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "FoodCli.hpp"
+#include "PlotCache.hpp"
+#include "WeightCli.hpp"
+
+namespace {
+
+constexpr uint32_t MAX_ARGS = 4096;
+constexpr uint32_t MAX_ARG_BYTES = 1u << 20;
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void on_stop_signal(int) { g_stop = 1; }
+
+std::string socket_path() {
+    return (std::filesystem::path(DAILYAPP_DATA_DIR) / "dailyapp.sock").string();
+}
+
+bool make_address(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// Socket connectée au démon, -1 si aucun n'écoute.
+int connect_daemon() {
+    sockaddr_un addr{};
+    if (!make_address(socket_path(), addr)) return -1;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool send_all(int fd, const void* data, size_t n) {
+    const auto* p = static_cast<const char*>(data);
+    while (n > 0) {
+        const ssize_t k = ::send(fd, p, n, MSG_NOSIGNAL);
+        if (k < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += k;
+        n -= static_cast<size_t>(k);
+    }
+    return true;
+}
+
+bool recv_all(int fd, void* data, size_t n) {
+    auto* p = static_cast<char*>(data);
+    while (n > 0) {
+        const ssize_t k = ::recv(fd, p, n, 0);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k;
+        n -= static_cast<size_t>(k);
+    }
+    return true;
+}
+
+bool send_blob(int fd, std::string_view s) {
+    const auto n = static_cast<uint32_t>(s.size());
+    return send_all(fd, &n, sizeof(n)) && send_all(fd, s.data(), s.size());
+}
+
+bool recv_blob(int fd, std::string& s, uint32_t limit) {
+    uint32_t n = 0;
+    if (!recv_all(fd, &n, sizeof(n)) || n > limit) return false;
+    s.resize(n);
+    return recv_all(fd, s.data(), n);
+}
+
+// État partagé par toutes les connexions.
+struct Daemon {
+    food::Session food;
+    weight::Session weight;
+    std::shared_mutex food_rw;
+    std::shared_mutex weight_rw;
+    std::atomic<int> active{0};
+};
+
+int dispatch(Daemon& d, std::span<const std::string_view> args, std::ostream& out, std::ostream& err) {
+    if (args.empty()) {
+        err << "Empty command\n";
+        return 2;
+    }
+    if (runs_locally(args)) {
+        err << "Commande interactive ou sur fichier local : lancer DailyApp avec DAILYAPP_NO_DAEMON=1\n";
+        return 2;
+    }
+    const std::string_view tracker = args[0];
+    const auto sub = args.subspan(1);
+    if (tracker == "food") {
+        if (food::is_read_only(sub)) {
+            std::shared_lock lock(d.food_rw);
+            return food::run(d.food, sub, out, err);
+        }
+        std::unique_lock lock(d.food_rw);
+        return food::run(d.food, sub, out, err);
+    }
+    if (tracker == "weight") {
+        if (weight::is_read_only(sub)) {
+            std::shared_lock lock(d.weight_rw);
+            return weight::run(d.weight, sub, out, err);
+        }
+        std::unique_lock lock(d.weight_rw);
+        return weight::run(d.weight, sub, out, err);
+    }
+    err << "Unknown tracker: " << tracker << "\n";
+    return 2;
+}
+
+void handle_client(Daemon& d, int fd) {
+    uint32_t argc = 0;
+    std::vector<std::string> storage;
+    bool ok = recv_all(fd, &argc, sizeof(argc)) && argc <= MAX_ARGS;
+    for (uint32_t i = 0; ok && i < argc; ++i) {
+        storage.emplace_back();
+        ok = recv_blob(fd, storage.back(), MAX_ARG_BYTES);
+    }
+    if (ok) {
+        std::vector<std::string_view> args(storage.begin(), storage.end());
+        std::ostringstream out, err;
+        int32_t rc = 0;
+        if (args.size() == 2 && args[0] == "serve" && args[1] == "stop") {
+            g_stop = 1;
+            out << "DailyApp serve: arrêt demandé\n";
+        } else {
+            rc = dispatch(d, args, out, err);
+        }
+        ok = send_all(fd, &rc, sizeof(rc)) && send_blob(fd, out.str()) && send_blob(fd, err.str());
+    }
+    ::close(fd);
+}
+
+} // namespace
+
+bool runs_locally(std::span<const std::string_view> args) {
+    if (args.size() < 2) return false;
+    if (args[0] == "food") return args[1] == "add-product" || args[1] == "import-products";
+    // le chemin d'export est relatif au dossier du client, pas à celui du démon
+    return args[0] == "weight" && args[1] == "trend" &&
+           std::find(args.begin() + 2, args.end(), "--export") != args.end();
+}
+
+int serve(std::span<const std::string_view> args) {
+    if (!args.empty() && args[0] == "stop") {
+        auto rc = forward_to_daemon(std::vector<std::string_view>{"serve", "stop"});
+        if (!rc) {
+            std::cerr << "Aucun démon DailyApp en cours.\n";
+            return 1;
+        }
+        return *rc;
+    }
+
+    const std::string path = socket_path();
+    sockaddr_un addr{};
+    if (!make_address(path, addr)) {
+        std::cerr << "Chemin de socket trop long: " << path << "\n";
+        return 1;
+    }
+    if (const int fd = connect_daemon(); fd >= 0) {
+        ::close(fd);
+        std::cerr << "Un démon DailyApp écoute déjà sur " << path << "\n";
+        return 1;
+    }
+
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    ::unlink(path.c_str()); // socket laissée par un démon arrêté brutalement
+
+    const int listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    const mode_t old_mask = ::umask(0077); // socket réservée à l'utilisateur
+    const bool bound = ::bind(listen_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    ::umask(old_mask);
+    if (!bound || ::listen(listen_fd, 64) != 0) {
+        std::cerr << "bind/listen " << path << ": " << std::strerror(errno) << "\n";
+        ::close(listen_fd);
+        return 1;
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = on_stop_signal;
+    ::sigaction(SIGINT, &sa, nullptr);
+    ::sigaction(SIGTERM, &sa, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    set_plot_worker(PlotWorker::Thread); // pas de fork d'un processus multi-thread
+    Daemon daemon;
+    // premier chargement avant d'accepter : les premières requêtes sont chaudes
+    daemon.food.products();
+    daemon.food.history();
+    std::cout << "DailyApp serve: écoute sur " << path << std::endl;
+
+    while (!g_stop) {
+        pollfd p{listen_fd, POLLIN, 0};
+        const int n = ::poll(&p, 1, 200);
+        if (n <= 0) continue; // délai écoulé ou signal : on revérifie g_stop
+        const int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        daemon.active.fetch_add(1);
+        std::thread([&daemon, fd] {
+            handle_client(daemon, fd);
+            daemon.active.fetch_sub(1);
+        }).detach();
+    }
+
+    ::close(listen_fd);
+    ::unlink(path.c_str());
+    while (daemon.active.load() > 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    wait_plot_workers();
+    std::cout << "DailyApp serve: arrêté\n";
+    return 0;
+}
+
+std::optional<int> forward_to_daemon(std::span<const std::string_view> args) {
+    const int fd = connect_daemon();
+    if (fd < 0) return std::nullopt;
+
+    const auto argc = static_cast<uint32_t>(args.size());
+    bool ok = send_all(fd, &argc, sizeof(argc));
+    for (size_t i = 0; ok && i < args.size(); ++i) ok = send_blob(fd, args[i]);
+
+    int32_t rc = 0;
+    std::string out, err;
+    ok = ok && recv_all(fd, &rc, sizeof(rc)) && recv_blob(fd, out, UINT32_MAX) && recv_blob(fd, err, UINT32_MAX);
+    ::close(fd);
+    if (!ok) {
+        // la commande a pu s'exécuter : pas de repli local (double écriture)
+        std::cerr << "DailyApp serve: réponse du démon interrompue\n";
+        return 1;
+    }
+    std::cout << out << std::flush;
+    std::cerr << err;
+    return rc;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <optional>
+#include <span>
+#include <string_view>
+
+// Mode démon : `DailyApp serve` garde les sessions food / weight en mémoire
+// et exécute les commandes reçues sur une socket Unix (data/dailyapp.sock).
+// Une requête = une commande : les commandes en lecture seule d'un tracker
+// s'exécutent en parallèle, les autres en exclusivité (verrou
+// lecteurs/rédacteur par tracker) ; les écritures vont sur disque comme en
+// CLI, le démon et les invocations directes restent donc interchangeables.
+//
+// Protocole (ordre d'octets natif, même machine) :
+//   requête : u32 argc, puis argc x (u32 taille, octets)
+//   réponse : i32 code, u32 taille, stdout, u32 taille, stderr
+
+// Boucle du démon ; rend la main sur SIGINT / SIGTERM ou `DailyApp serve stop`.
+int serve(std::span<const std::string_view> args);
+
+// Client : exécute args (<tracker> <commande> ...) via le démon s'il tourne,
+// et recopie ses sorties. nullopt si aucun démon n'écoute (exécution locale).
+std::optional<int> forward_to_daemon(std::span<const std::string_view> args);
+
+// Commandes jamais transmises au démon (saisie au clavier, fichier local).
+bool runs_locally(std::span<const std::string_view> args);
@@ -1,10 +1,15 @@
+#include <cstdlib>
 #include <iostream>
+#include <string>
 #include <string_view>
 #include <vector>
 #include <span>
 
 #include "WeightCli.hpp"
+#include "BatchRunner.hpp"
 #include "FoodCli.hpp"
+#include "Profile.hpp"
+#include "Server.hpp"
 
 static void print_help() {
     std::cout <<
@@ -12,21 +17,37 @@ R"(DailyApp launcher
 
 Usage:
   DailyApp --help
+  DailyApp --profile[=trace.json] <tracker|batch|serve> ...
   DailyApp <tracker> --help
   DailyApp weight <command> [args...]
   DailyApp food   <command> [args...]
+  DailyApp batch <file|->
+  DailyApp serve [stop]
 
 Trackers:
   weight   Weight tracker
   food     Food tracker
+
+Batch:
+  batch    Exécute une commande weight/food par ligne dans un seul processus ;
+           les écritures et la mise à jour de food_history.csv sont faites
+           une fois, à la fin.
+
+Daemon:
+  serve    Garde les données en mémoire et exécute les commandes weight/food
+           reçues sur data/dailyapp.sock ; tant qu'il tourne, DailyApp lui
+           transmet les commandes (DAILYAPP_NO_DAEMON=1 pour s'en passer).
+  serve stop  Arrête le démon.
+
+Profiling:
+  --profile   Temps, appels et allocations par zone (chargements, scans,
+              écritures, rendu), compteurs et appels système, sur stderr à
+              la fin ; --profile=trace.json écrit aussi une trace Chrome /
+              Perfetto. La commande s'exécute dans ce processus.
 )";
 }
 
-int main(int argc, char** argv) {
-    std::vector<std::string_view> args;
-    args.reserve(static_cast<size_t>(argc));
-    for (int i = 0; i < argc; ++i) args.emplace_back(argv[i]);
-
+static int dispatch(const std::vector<std::string_view>& args, bool profiling) {
     if (args.size() <= 1 || args[1] == "--help" || args[1] == "-h") {
         print_help();
         return 0;
@@ -37,6 +58,22 @@ int main(int argc, char** argv) {
     // subArgs = everything after "<tracker>"
     std::span<const std::string_view> subArgs(args.data() + 2, args.size() - 2);
 
+    if (tracker == "batch") {
+        return run_batch(subArgs);
+    }
+
+    if (tracker == "serve") {
+        return serve(subArgs);
+    }
+
+    // --profile mesure ce processus : la commande n'est pas confiée au démon
+    if ((tracker == "weight" || tracker == "food") && !profiling && !std::getenv("DAILYAPP_NO_DAEMON")) {
+        std::span<const std::string_view> command(args.data() + 1, args.size() - 1);
+        if (!runs_locally(command)) {
+            if (auto rc = forward_to_daemon(command)) return *rc;
+        }
+    }
+
     if (tracker == "weight") {
         // Allow: DailyApp weight --help
         return weight::run(subArgs);
@@ -49,3 +86,38 @@ int main(int argc, char** argv) {
     print_help();
     return 2;
 }
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args;
+    args.reserve(static_cast<size_t>(argc));
+    for (int i = 0; i < argc; ++i) args.emplace_back(argv[i]);
+
+    // --profile[=trace.json] avant le tracker : récapitulatif sur stderr
+    bool profiling = false;
+    std::string trace;
+    if (args.size() > 1 && (args[1] == "--profile" || args[1].starts_with("--profile="))) {
+        if (!profile::compiled) {
+            std::cerr << "--profile: DailyApp compilé sans DAILYAPP_PROFILING\n";
+            return 2;
+        }
+        profiling = true;
+        if (args[1].size() > 10) trace = std::string(args[1].substr(10));
+        args.erase(args.begin() + 1);
+        profile::start(!trace.empty());
+    }
+
+    int rc = 0;
+    {
+        PROFILE_ZONE("DailyApp");
+        rc = dispatch(args, profiling);
+    }
+
+    if (profiling) {
+        profile::report(std::cerr);
+        if (!trace.empty()) {
+            if (profile::write_trace(trace)) std::cerr << "Trace: " << trace << "\n";
+            else std::cerr << "Trace: écriture impossible: " << trace << "\n";
+        }
+    }
+    return rc;
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include "Date.hpp"
 #include "Product.hpp"
+#include "Record.hpp"
 #include <string>
+#include <string_view>
 
 struct Batch {
   std::string batch_id;
@@ -12,3 +14,41 @@ struct Batch {
   Unit unit{};
   std::string comment;
 };
+
+// Lot sans copie (champs texte pointant dans le texte lu).
+struct BatchView {
+  std::string_view batch_id;
+  Date start{};
+  int days = 0;
+  std::string_view product_id;
+  double qty = 0.0;
+  Unit unit{};
+  std::string_view comment;
+};
+
+// food_batches.csv: batch_id,start_date,days,product_id,qty,unit,comment
+template <>
+struct record::Schema<Batch> {
+  static constexpr auto columns = std::tuple{
+    record::column("batch_id", &Batch::batch_id),
+    record::column("start_date", &Batch::start),
+    record::column("days", &Batch::days).checked(record::positive<int>),
+    record::column("product_id", &Batch::product_id),
+    record::column("qty", &Batch::qty),
+    record::column("unit", &Batch::unit),
+    record::optional_column("comment", &Batch::comment),
+  };
+};
+
+template <>
+struct record::Schema<BatchView> {
+  static constexpr auto columns = std::tuple{
+    record::column("batch_id", &BatchView::batch_id),
+    record::column("start_date", &BatchView::start),
+    record::column("days", &BatchView::days).checked(record::positive<int>),
+    record::column("product_id", &BatchView::product_id),
+    record::column("qty", &BatchView::qty),
+    record::column("unit", &BatchView::unit),
+    record::optional_column("comment", &BatchView::comment),
+  };
+};
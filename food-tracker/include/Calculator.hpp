@@ -1,16 +1,54 @@
 #pragma once
 #include "Date.hpp"
-#include <map>
 #include <string>
+#include <vector>
 
 struct ProductDB;
+struct ProductView;
+class Snapshot;
 
+// Macros journalières denses : la case i correspond à add_days(start, i).
 struct DayMacros {
-  std::map<std::string, double> kcal;
-  std::map<std::string, double> prot;
-  std::map<std::string, double> fiber;
+  Date start{};
+  std::vector<double> kcal;
+  std::vector<double> prot;
+  std::vector<double> fiber;
+
+  size_t size() const { return kcal.size(); }
+  Date date_at(size_t i) const { return add_days(start, static_cast<int>(i)); }
+};
+
+// Accumule lots et extras sur [start, start + days).
+// Un lot est un ajout sur une plage : O(1) via un tableau de différences,
+// puis finish() fait une seule passe de somme préfixe.
+struct DayAccumulator {
+  DayAccumulator(const Date& start, int days);
+
+  void add_range(const Date& first, int count, double kcal_day, double prot_day, double fiber_day);
+  void add_batch(const Date& bstart, int bdays, const ProductView& p, double qty);
+  void add_day(const Date& d, double kcal, double prot, double fiber);
+
+  DayMacros finish();
+
+private:
+  DayMacros out;                   // valeurs ponctuelles (extras)
+  std::vector<double> dk, dp, df;  // différences des lots, taille days + 1
+  std::vector<int> active;         // différences du nombre de lots actifs
 };
 
+// Snapshots (cf. Snapshot.hpp) de food_batches.csv / food_extras.csv,
+// importés depuis le CSV s'ils sont absents ou périmés.
+Snapshot load_batches_snapshot(const std::string& batches_csv);
+Snapshot load_extras_snapshot(const std::string& extras_csv);
+
+DayMacros compute_daily_macros(
+  const ProductDB& db,
+  const Snapshot& batches,
+  const Snapshot& extras,
+  const Date& start,
+  int days
+);
+
 DayMacros compute_daily_kcal_and_prot_and_fiber(
   const ProductDB& db,
   const std::string& batches_csv,
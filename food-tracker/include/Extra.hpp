@@ -1,6 +1,8 @@
 #pragma once
 #include "Date.hpp"
+#include "Record.hpp"
 #include <string>
+#include <string_view>
 
 struct Extra {
     Date date{};
@@ -9,3 +11,35 @@ struct Extra {
     double fiber = 0.0;
     std::string comment;
 };
+
+// Ligne d'extra sans copie (commentaire pointant dans le texte lu).
+struct ExtraView {
+    Date date{};
+    double kcal = 0.0;
+    double prot = 0.0;
+    double fiber = 0.0;
+    std::string_view comment;
+};
+
+// food_extras.csv: date,kcal,prot,fiber,comment
+template <>
+struct record::Schema<Extra> {
+    static constexpr auto columns = std::tuple{
+        record::column("date", &Extra::date),
+        record::column("kcal", &Extra::kcal),
+        record::column("prot", &Extra::prot),
+        record::column("fiber", &Extra::fiber),
+        record::optional_column("comment", &Extra::comment),
+    };
+};
+
+template <>
+struct record::Schema<ExtraView> {
+    static constexpr auto columns = std::tuple{
+        record::column("date", &ExtraView::date),
+        record::column("kcal", &ExtraView::kcal),
+        record::column("prot", &ExtraView::prot),
+        record::column("fiber", &ExtraView::fiber),
+        record::optional_column("comment", &ExtraView::comment),
+    };
+};
@@ -1,7 +1,68 @@
 #pragma once
+#include "Batch.hpp"
+#include "Date.hpp"
+#include "Extra.hpp"
+#include "ProductDB.hpp"
+#include "Snapshot.hpp"
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <span>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace food {
+    // Écritures différées (DailyApp batch) : lignes à ajouter aux sources et
+    // apports correspondants, appliqués à food_history.csv en une fois.
+    // Un draft commité est mis de côté (drafts) : supprimé une fois ses lots
+    // écrits, remis en place si l'écriture échoue.
+    struct PendingWrites {
+        std::vector<std::string> batch_rows, extra_rows;
+        std::vector<Batch> batches;
+        std::vector<Extra> extras;
+        std::vector<std::string> drafts;
+    };
+
+    // Données gardées entre deux commandes d'un même processus (DailyApp
+    // serve) : catalogue et food_history projetés, rechargés seulement quand
+    // leur CSV a changé. Thread-safe ; une commande garde le shared_ptr
+    // reçu jusqu'à la fin, un rechargement concurrent ne l'invalide pas.
+    class Session {
+    public:
+        Session();
+
+        std::shared_ptr<const ProductDB> products();
+        std::shared_ptr<const Snapshot> history(); // nullptr si le CSV manque
+        // Lignes couvrant `range` : l'historique déjà chargé s'il est à jour,
+        // sinon une lecture de la plage seule (cf. load_history_range).
+        std::shared_ptr<const Snapshot> history(const DateRange& range);
+
+        // Après defer_writes(), add-extra et draft-commit remplissent
+        // pending() au lieu d'écrire ; flush_writes() ajoute les lignes aux
+        // sources puis met food_history.csv à jour une seule fois.
+        void defer_writes();
+        PendingWrites* pending(); // nullptr hors mode différé
+        int flush_writes(std::ostream& err);
+
+    private:
+        std::mutex mutex_;
+        std::string products_csv_;
+        std::string batches_csv_;
+        std::string extras_csv_;
+        std::string history_csv_;
+        std::optional<PendingWrites> pending_;
+        std::shared_ptr<const ProductDB> db_;
+        SourceStamp db_stamp_{};
+        std::shared_ptr<const Snapshot> history_;
+        SourceStamp history_stamp_{};
+    };
+
+    // Commandes qui ne modifient aucun fichier (lecteurs concurrents possibles).
+    bool is_read_only(std::span<const std::string_view> args);
+
     int run(std::span<const std::string_view> args);
+    int run(Session& session, std::span<const std::string_view> args,
+            std::ostream& out, std::ostream& err);
 }
@@ -0,0 +1,64 @@
+#pragma once
+#include "Batch.hpp"
+#include "Date.hpp"
+#include "Extra.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct ProductDB;
+class Snapshot;
+
+// food_history.csv (date,kcal,protein,fiber) est un cache dense, un jour par
+// ligne, dérivé de food_batches.csv + food_extras.csv.
+
+// Recalcul complet depuis les deux CSV sources.
+int rebuild_food_history_csv(const ProductDB& db,
+                             const std::string& batches,
+                             const std::string& extras,
+                             const std::string& out_csv,
+                             std::ostream& err = std::cerr);
+
+// true si le cache n'est pas plus ancien que ses sources (à tester avant
+// d'ajouter de nouvelles lignes aux sources).
+bool food_history_is_current(const std::string& history_csv,
+                             const std::string& batches,
+                             const std::string& extras);
+
+// Applique des lignes tout juste ajoutées aux sources : seuls les jours touchés
+// sont recalculés (les apports sont additifs) et la fin du fichier est réécrite
+// à partir du premier jour touché ; la plage est prolongée si besoin.
+// Retombe sur rebuild_food_history_csv quand le patch n'est pas applicable.
+int update_food_history_csv(const ProductDB& db,
+                            const std::vector<Batch>& new_batches,
+                            const std::vector<Extra>& new_extras,
+                            const std::string& batches,
+                            const std::string& extras,
+                            const std::string& out_csv,
+                            std::ostream& err = std::cerr);
+
+// Snapshot (cf. Snapshot.hpp) de food_history.csv.
+Snapshot load_history_snapshot(const std::string& history_csv);
+
+// Pour une requête sur une plage : snapshot persisté s'il est à jour (la
+// plage y est cherchée à l'affichage), sinon seulement les lignes de la plage,
+// trouvées par dichotomie dans le CSV projeté.
+Snapshot load_history_range(const std::string& history_csv, const DateRange& range);
+
+// Jours consécutifs identiques regroupés en une ligne (jours de `range` seulement).
+int print_grouped_history(const Snapshot& history, std::ostream& out, const DateRange& range = {});
+
+// Totaux d'une plage de jours, lus dans les sommes préfixes du snapshot :
+// deux dichotomies sur les dates puis une soustraction par nutriment.
+struct NutrientTotals {
+  int days = 0;
+  double kcal = 0.0, prot = 0.0, fiber = 0.0;
+};
+NutrientTotals history_totals(const Snapshot& history, const DateRange& range);
+
+enum class StatsPeriod { Range, Week, Month };
+
+// Une ligne par période (semaine du lundi, mois civil ou toute la plage),
+// bornée aux jours présents : totaux et moyennes par jour.
+int print_history_stats(const Snapshot& history, std::ostream& out,
+                        const DateRange& range, StatsPeriod by);
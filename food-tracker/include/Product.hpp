@@ -1,5 +1,7 @@
 #pragma once
+#include "Record.hpp"
 #include <string>
+#include <string_view>
 
 enum class Unit { G, ML };
 
@@ -7,6 +9,22 @@ inline std::string to_string(Unit u) {
   return (u == Unit::G) ? "g" : "mL";
 }
 
+// "g" ou "mL" (insensible à la casse) ; défaut : g
+inline Unit parse_unit(std::string_view s) {
+  while (!s.empty() && s.front() == ' ') s.remove_prefix(1);
+  while (!s.empty() && s.back() == ' ') s.remove_suffix(1);
+  if (s.size() == 2 && (s[0] == 'm' || s[0] == 'M') && (s[1] == 'l' || s[1] == 'L')) return Unit::ML;
+  return Unit::G;
+}
+
+// Unité inconnue : g, comme parse_unit (jamais rejetée).
+template <>
+struct record::Codec<Unit> {
+  static constexpr std::string_view invalid = "unité invalide";
+  static bool decode(std::string_view s, Unit& out) { out = parse_unit(s); return true; }
+  static void encode(std::string& out, Unit u) { out += (u == Unit::G) ? "g" : "mL"; }
+};
+
 struct Product {
   std::string id;
   std::string name;
@@ -16,3 +34,46 @@ struct Product {
   double fiber_per_100 = 0.0;
   std::string aliases_raw;     // "pain|mie|toast"
 };
+
+// Fiche produit sans copie (champs texte pointant dans le catalogue projeté).
+struct ProductView {
+  std::string_view id;
+  std::string_view name;
+  Unit unit{};
+  double kcal_per_100 = 0.0;
+  double prot_per_100 = 0.0;
+  double fiber_per_100 = 0.0;
+  std::string_view aliases_raw;
+
+  Product to_product() const {
+    return Product{std::string(id), std::string(name), unit,
+                   kcal_per_100, prot_per_100, fiber_per_100, std::string(aliases_raw)};
+  }
+};
+
+// food_products.csv: id,name,unit,kcal_per_100,prot_per_100,fiber_per_100,aliases
+template <>
+struct record::Schema<Product> {
+  static constexpr auto columns = std::tuple{
+    record::column("id", &Product::id),
+    record::column("name", &Product::name),
+    record::column("unit", &Product::unit),
+    record::column("kcal_per_100", &Product::kcal_per_100),
+    record::column("prot_per_100", &Product::prot_per_100),
+    record::column("fiber_per_100", &Product::fiber_per_100),
+    record::optional_column("aliases", &Product::aliases_raw),
+  };
+};
+
+template <>
+struct record::Schema<ProductView> {
+  static constexpr auto columns = std::tuple{
+    record::column("id", &ProductView::id),
+    record::column("name", &ProductView::name),
+    record::column("unit", &ProductView::unit),
+    record::column("kcal_per_100", &ProductView::kcal_per_100),
+    record::column("prot_per_100", &ProductView::prot_per_100),
+    record::column("fiber_per_100", &ProductView::fiber_per_100),
+    record::optional_column("aliases", &ProductView::aliases_raw),
+  };
+};
@@ -1,18 +1,45 @@
 #pragma once
 #include "Product.hpp"
-#include <unordered_map>
+#include "Snapshot.hpp"
+#include <cstdint>
+#include <iosfwd>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
-struct ProductDB {
-  std::vector<Product> products;
-  std::unordered_map<std::string, size_t> by_id;     // id -> index
-  std::unordered_map<std::string, size_t> by_token;  // alias/name token -> index
+// Catalogue produits. Les fiches et leurs index (id -> produit et
+// jeton id/nom/alias -> produit, en tables à adressage ouvert ; index
+// inversé de trigrammes pour la recherche par sous-chaîne ; BK-tree des
+// termes sans accents pour la recherche approchée) vivent dans
+// food_products.snap, projeté en mémoire : tant que le CSV ne change pas,
+// un chargement ne parse rien et la page cache est partagée entre processus.
+struct FuzzyMatch {
+  size_t product = 0;
+  int distance = 0;
+};
 
+struct ProductDB {
   bool load(const std::string& path);
-  bool add_interactive(const std::string& path); // ajoute + append dans products.csv
+  // saisie guidée sur in/out, puis append dans products.csv
+  bool add_interactive(const std::string& path, std::istream& in, std::ostream& out) const;
+
+  size_t size() const { return snap.rows(); }
+  ProductView view(size_t i) const;
+  std::optional<size_t> find_id(std::string_view id) const;       // insensible à la casse
+  std::optional<size_t> find_token(std::string_view token) const; // id, nom ou alias exact
 
   std::optional<Product> get_by_id(const std::string& id) const;
-  std::vector<Product> search(const std::string& query) const; // simple contains
-  std::optional<Product> resolve(const std::string& user_input) const; // id ou alias unique
+  // Sous-chaîne insensible à la casse dans id, nom ou alias ; index
+  // croissants, au plus `limit` résultats.
+  std::vector<size_t> search(std::string_view query, size_t limit = SIZE_MAX) const;
+  std::optional<size_t> resolve(std::string_view user_input) const; // id ou alias unique
+
+  // Top-k tolérant aux fautes : produits dont l'id, le nom, un mot du nom ou
+  // un alias (sans accents ni casse) est à distance d'édition bornée de la
+  // requête ; triés par distance de frappe (inversions comprises).
+  std::vector<FuzzyMatch> fuzzy(std::string_view query, size_t k = 5) const;
+
+private:
+  Snapshot snap;
 };
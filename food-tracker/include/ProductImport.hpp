@@ -0,0 +1,37 @@
+#pragma once
+#include "ProductDB.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
+// Import en masse d'un catalogue externe (CSV ; TSV ou ';' détectés sur
+// l'en-tête, ex. export OpenFoodFacts) vers food_products.csv.
+//
+// La source est lue par blocs de `chunk_bytes` coupés sur des fins
+// d'enregistrement ; chaque bloc est parsé en parallèle puis fusionné dans
+// l'ordre du fichier, la mémoire reste donc bornée (hors ensemble des ids) ;
+// une ligne plus longue qu'un bloc est comptée invalide et sautée.
+// Un id déjà présent (catalogue ou plus haut dans la source) est ignoré.
+struct ProductImportOptions {
+  // champ Product (id, name, unit, kcal, kj, prot, fiber, aliases) -> colonne source
+  std::vector<std::pair<std::string, std::string>> columns;
+  unsigned threads = 0; // 0 = parse_threads()
+  size_t chunk_bytes = size_t{16} << 20;
+};
+
+struct ProductImportReport {
+  size_t rows = 0;       // lignes de données lues
+  size_t added = 0;
+  size_t duplicates = 0;
+  size_t invalid = 0;    // id, nom ou énergie manquant ou illisible, ligne trop longue
+  double seconds = 0.0;
+};
+
+// Ajoute les produits de `source` à la fin de `catalog_csv` (les index sont
+// reconstruits au prochain ProductDB::load). Les lignes sont écrites dans une
+// copie du catalogue renommée à la fin : en cas d'échec le catalogue est
+// inchangé. Faux + `error` si la source est illisible, si les colonnes
+// requises (id, name, kcal ou kj) manquent ou si l'écriture échoue.
+bool import_products_file(const ProductDB& db, const std::string& catalog_csv,
+                          const std::string& source, const ProductImportOptions& opt,
+                          ProductImportReport& report, std::string& error);
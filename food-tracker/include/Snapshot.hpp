@@ -0,0 +1,134 @@
+#pragma once
+#include "Csv.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Snapshot binaire colonnaire d'un CSV (fichier <nom>.snap à côté du CSV).
+//
+// Format v6, little-endian, toutes les colonnes alignées sur 8 octets :
+//   SnapHeader | SnapColumn[columns] | données des colonnes
+// Colonnes à largeur fixe (i32 / f64 / u8) de `rows` valeurs ; les colonnes
+// u32 (tables d'index) et texte sont de longueur libre. Une colonne texte est
+// un tableau de {offset,len} (u32) dans la colonne Pool, toujours dernière.
+// Le CSV reste la source éditable : le snapshot mémorise sa taille et son
+// mtime et est ignoré dès qu'ils ne correspondent plus.
+
+enum class SnapshotKind : uint32_t { Products = 1, Batches = 2, Extras = 3, History = 4 };
+enum class ColumnType : uint32_t { I32 = 1, F64 = 2, U8 = 3, Str = 4, Pool = 5, U32 = 6 };
+
+// Colonnes par type de fichier (index = position dans le snapshot)
+namespace snapcol {
+  enum Products { P_ID, P_NAME, P_UNIT, P_KCAL, P_PROT, P_FIBER, P_ALIASES,
+                  P_ID_SLOTS, P_TOKENS, P_TOKEN_PRODUCT, P_TOKEN_SLOTS,
+                  P_SEARCH_TEXT, P_GRAM_KEYS, P_GRAM_OFFSETS, P_GRAM_POSTINGS,
+                  P_FUZZY_TERMS, P_FUZZY_PRODUCT, P_FUZZY_OFFSETS,
+                  P_BK_CHILD, P_BK_SIBLING, P_BK_EDGE };
+  enum Batches  { B_ID, B_START, B_DAYS, B_PRODUCT, B_QTY, B_UNIT, B_COMMENT };
+  enum Extras   { E_DATE, E_KCAL, E_PROT, E_FIBER, E_COMMENT };
+  enum History  { H_DATE, H_KCAL, H_PROT, H_FIBER,
+                  H_KCAL_SUM, H_PROT_SUM, H_FIBER_SUM }; // sommes préfixes (ligne incluse)
+}
+
+struct SourceStamp {
+  uint64_t size = 0;
+  int64_t mtime_ns = 0;
+  bool ok = false;
+
+  friend bool operator==(const SourceStamp&, const SourceStamp&) = default;
+};
+SourceStamp stamp_of(const std::string& path);
+std::string snapshot_path_for(const std::string& csv_path);
+
+// Colonne texte en cours d'import : les champs sont copiés, les vues d'un
+// CsvReader ne vivant que le temps d'une ligne.
+struct StrColumn {
+  std::string chars;
+  std::vector<size_t> ends;
+
+  void push(std::string_view s) { chars += s; ends.push_back(chars.size()); }
+  void append(const StrColumn& other) {
+    const size_t base = chars.size();
+    chars += other.chars;
+    for (size_t e : other.ends) ends.push_back(base + e);
+  }
+  size_t size() const { return ends.size(); }
+  std::string_view at(size_t i) const {
+    const size_t b = i ? ends[i - 1] : 0;
+    return std::string_view(chars).substr(b, ends[i] - b);
+  }
+};
+
+// Construit un snapshot en mémoire, colonne par colonne (dans l'ordre).
+class SnapshotBuilder {
+public:
+  SnapshotBuilder(SnapshotKind kind, size_t rows);
+
+  void add_i32(std::span<const int32_t> col);
+  void add_u32(std::span<const uint32_t> col);
+  void add_f64(std::span<const double> col);
+  void add_u8(std::span<const uint8_t> col);
+  void add_str(std::span<const std::string_view> col);
+  void add_str(const StrColumn& col);
+
+  // Image complète du fichier (ajoute la colonne Pool) ; vide si le texte
+  // des colonnes dépasse 4 Gio (offsets u32), rien n'est alors à écrire.
+  std::vector<uint64_t> finish(const SourceStamp& src);
+
+private:
+  struct Col { ColumnType type; std::vector<uint8_t> bytes; };
+  SnapshotKind kind_;
+  size_t rows_;
+  std::vector<Col> cols_;
+  std::string pool_;
+  bool overflow_ = false;
+};
+
+// Vue en lecture sur un snapshot : soit projeté depuis le disque, soit
+// construit en mémoire à partir du CSV.
+class Snapshot {
+public:
+  Snapshot() = default;
+
+  // Invalide si absent, corrompu, d'une autre version ou périmé.
+  static Snapshot open(const std::string& snap_path, SnapshotKind kind, const SourceStamp& src);
+  static Snapshot from_image(std::vector<uint64_t> image, SnapshotKind kind);
+
+  bool valid() const { return valid_; }
+  size_t rows() const { return rows_; }
+
+  std::span<const int32_t> i32(size_t col) const;
+  std::span<const uint32_t> u32(size_t col) const; // longueur libre
+  std::span<const double> f64(size_t col) const;
+  std::span<const uint8_t> u8(size_t col) const;
+  std::string_view str(size_t col, size_t row) const;
+  size_t str_count(size_t col) const;
+
+  std::span<const uint8_t> bytes() const { return {base_, size_}; }
+
+private:
+  bool attach(const uint8_t* base, size_t size, SnapshotKind kind);
+  std::span<const uint8_t> column(size_t col, ColumnType type, size_t width) const;
+
+  MappedFile file_;
+  std::vector<uint64_t> image_;
+  const uint8_t* base_ = nullptr;
+  size_t size_ = 0;
+  size_t rows_ = 0;
+  size_t ncols_ = 0;
+  bool valid_ = false;
+};
+
+// Écrit l'image à côté du CSV (fichier temporaire puis rename).
+bool write_snapshot(const std::string& snap_path, std::span<const uint64_t> image);
+
+// Importe le CSV (stamp pris avant la lecture) vers une image de snapshot.
+using SnapshotImporter = std::vector<uint64_t> (*)(const std::string& csv, const SourceStamp& src);
+
+// Snapshot à jour de `csv`, sinon import du CSV (+ réécriture du snapshot
+// quand DAILYAPP_SNAPSHOTS est actif). Un CSV absent donne un snapshot vide ;
+// un import refusé (texte > 4 Gio) est signalé sur stderr, n'écrit rien et
+// donne un snapshot invalide.
+Snapshot load_or_import_snapshot(const std::string& csv, SnapshotKind kind, SnapshotImporter import);
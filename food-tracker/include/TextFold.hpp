@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+// Minuscules + suppression des accents (UTF-8, Latin-1 et œ/æ/ß) :
+// "Pâtes Crème Brûlée" -> "pates creme brulee". Les autres caractères
+// non ASCII sont recopiés tels quels.
+std::string fold_text(std::string_view s);
+
+// Distance de Levenshtein (octets), arrêt anticipé : toute valeur > bound
+// est renvoyée comme bound + 1.
+int edit_distance(std::string_view a, std::string_view b, int bound);
+
+// Distance de frappe (Damerau restreinte) : comme Levenshtein, mais une
+// inversion de deux lettres voisines ne coûte qu'une opération. Sert au
+// classement ; ce n'est pas une métrique (pas d'index BK-tree dessus).
+int typo_distance(std::string_view a, std::string_view b);
@@ -1,89 +1,241 @@
 #include "Calculator.hpp"
+#include "Batch.hpp"
+#include "Extra.hpp"
 #include "ProductDB.hpp"
 #include "Csv.hpp"
+#include "Snapshot.hpp"
 #include "Date.hpp"
+#include "Profile.hpp"
+#include "Record.hpp"
+#include <algorithm>
 #include <iostream>
 
-static bool in_range(const Date& d, const Date& start, const Date& end) {
-  return !(d < start) && !(end < d);
+DayAccumulator::DayAccumulator(const Date& start, int days) {
+  const size_t n = days > 0 ? static_cast<size_t>(days) : 0;
+  out.start = start;
+  out.kcal.assign(n, 0.0);
+  out.prot.assign(n, 0.0);
+  out.fiber.assign(n, 0.0);
+  dk.assign(n + 1, 0.0);
+  dp.assign(n + 1, 0.0);
+  df.assign(n + 1, 0.0);
+  active.assign(n + 1, 0);
 }
-DayMacros compute_daily_kcal_and_prot_and_fiber(
-  const ProductDB& db,
-  const std::string& batches_csv,
-  const std::string& extras_csv,
-  const Date& start,
-  int days
-) {
-  DayMacros out;
-  Date end = add_days(start, days - 1);
-
-  // init 0
-  Date cur = start;
-  for (int i = 0; i < days; ++i) {
-    const auto key = format_date(cur);
-    out.kcal[key] = 0.0;
-    out.prot[key] = 0.0;
-    out.fiber[key] = 0.0;
-    cur = add_days(cur, 1);
-  }
-
-  // batches
-  auto blines = read_lines(batches_csv);
-  for (size_t i = 1; i < blines.size(); ++i) {
-    auto c = split_csv_simple(blines[i]);
-    // batch_id,start_date,days,product_id,qty,unit,comment
-  // comment is optional -> accept 6 or 7+ cols
-  if (c.size() < 6) continue;
 
-  Date bstart{};
-  if (!parse_date_yyyy_mm_dd(c[1], bstart)) continue;
-  int bdays = std::stoi(c[2]);
-  if (bdays <= 0) continue;
+void DayAccumulator::add_range(const Date& first, int count,
+                               double kcal_day, double prot_day, double fiber_day) {
+  if (count <= 0) return;
+  // plage [lo, hi) exprimée en offsets, bornée à [0, size)
+  const long long n  = static_cast<long long>(out.size());
+  const long long lo = std::max<long long>(days_between(out.start, first), 0);
+  const long long hi = std::min<long long>(days_between(out.start, first) + (long long)count, n);
+  if (lo >= hi) return;
+
+  dk[lo] += kcal_day;  dk[hi] -= kcal_day;
+  dp[lo] += prot_day;  dp[hi] -= prot_day;
+  df[lo] += fiber_day; df[hi] -= fiber_day;
+  active[lo] += 1;     active[hi] -= 1;
+}
 
-  std::string pid = trim(c[3]);
-  double qty = std::stod(c[4]);
+void DayAccumulator::add_batch(const Date& bstart, int bdays, const ProductView& p, double qty) {
+  if (bdays <= 0) return;
+  add_range(bstart, bdays,
+            (qty * p.kcal_per_100 / 100.0) / (double)bdays,
+            (qty * p.prot_per_100 / 100.0) / (double)bdays,
+            (qty * p.fiber_per_100 / 100.0) / (double)bdays);
+}
 
+void DayAccumulator::add_day(const Date& d, double kcal, double prot, double fiber) {
+  const int i = days_between(out.start, d);
+  if (i < 0 || static_cast<size_t>(i) >= out.size()) return;
+  out.kcal[i]  += kcal;
+  out.prot[i]  += prot;
+  out.fiber[i] += fiber;
+}
 
-    auto p = db.get_by_id(pid);
-    if (!p.has_value()) continue;
+DayMacros DayAccumulator::finish() {
+  double k = 0.0, p = 0.0, f = 0.0;
+  int n_active = 0;
+  for (size_t i = 0; i < out.size(); ++i) {
+    n_active += active[i];
+    if (n_active == 0) {
+      // aucun lot ouvert : on repart de zéro exact (pas de résidu flottant)
+      k = p = f = 0.0;
+    } else {
+      k += dk[i]; p += dp[i]; f += df[i];
+    }
+    out.kcal[i]  += k;
+    out.prot[i]  += p;
+    out.fiber[i] += f;
+  }
+  return std::move(out);
+}
 
-    double kcal_day = (qty * p->kcal_per_100 / 100.0) / (double)bdays;
-    double prot_day = (qty * p->prot_per_100 / 100.0) / (double)bdays;
-    double fiber_day = (qty * p->fiber_per_100 / 100.0) / (double)bdays;
-
-    for (int k = 0; k < bdays; ++k) {
-      Date d = add_days(bstart, k);
-      if (!in_range(d, start, end)) continue;
-      const auto key = format_date(d);
-      out.kcal[key] += kcal_day;
-      out.prot[key] += prot_day;
-      out.fiber[key] += fiber_day;
+struct BatchColumns {
+  StrColumn ids, pids, comments;
+  std::vector<int32_t> starts, ndays;
+  std::vector<double> qtys;
+  std::vector<uint8_t> units;
+  record::RowIssues issues;
+
+  void append(const BatchColumns& o) {
+    ids.append(o.ids);
+    pids.append(o.pids);
+    comments.append(o.comments);
+    starts.insert(starts.end(), o.starts.begin(), o.starts.end());
+    ndays.insert(ndays.end(), o.ndays.begin(), o.ndays.end());
+    qtys.insert(qtys.end(), o.qtys.begin(), o.qtys.end());
+    units.insert(units.end(), o.units.begin(), o.units.end());
+    issues.merge(o.issues);
+  }
+};
+
+static void parse_batch_rows(std::string_view text, BatchColumns& out) {
+  auto reader = CsvReader::from_text(text);
+  std::span<const std::string_view> c;
+  BatchView b;
+  record::RowError err;
+  while (reader.next(c)) {
+    if (!record::decode(reader, c, b, err)) {
+      out.issues.note(reader.record(), err);
+      continue;
     }
+    out.ids.push(b.batch_id);
+    out.starts.push_back(b.start.serial);
+    out.ndays.push_back(b.days);
+    out.pids.push(b.product_id);
+    out.qtys.push_back(b.qty);
+    out.units.push_back(static_cast<uint8_t>(b.unit));
+    out.comments.push(b.comment);
   }
+}
 
-  auto elines = read_lines(extras_csv);
-  for (size_t i = 1; i < elines.size(); ++i) {
-    auto c = split_csv_simple(elines[i]);
+// food_batches.csv: batch_id,start_date,days,product_id,qty,unit,comment
+static std::vector<uint64_t> import_batches(const std::string& csv, const SourceStamp& src) {
+  MappedFile file(csv);
+  auto reader = CsvReader::from_text(file.data());
+  std::span<const std::string_view> header;
+  const bool header_ok = !reader.next(header) || record::check_header<BatchView>(header);
+
+  const auto ranges = parse_ranges(reader.remaining());
+  auto parts = parse_parallel<BatchColumns>(ranges, parse_batch_rows);
+  BatchColumns cols = std::move(parts.front());
+  for (size_t i = 1; i < parts.size(); ++i) cols.append(parts[i]);
+  record::report<BatchView>(std::cerr, csv, file.data(), header_ok, cols.issues);
+
+  SnapshotBuilder b(SnapshotKind::Batches, cols.starts.size());
+  b.add_str(cols.ids);       // B_ID
+  b.add_i32(cols.starts);    // B_START
+  b.add_i32(cols.ndays);     // B_DAYS
+  b.add_str(cols.pids);      // B_PRODUCT
+  b.add_f64(cols.qtys);      // B_QTY
+  b.add_u8(cols.units);      // B_UNIT
+  b.add_str(cols.comments);  // B_COMMENT
+  return b.finish(src);
+}
+
+struct ExtraColumns {
+  std::vector<int32_t> dates;
+  std::vector<double> kcal, prot, fiber;
+  StrColumn comments;
+  record::RowIssues issues;
+
+  void append(const ExtraColumns& o) {
+    dates.insert(dates.end(), o.dates.begin(), o.dates.end());
+    kcal.insert(kcal.end(), o.kcal.begin(), o.kcal.end());
+    prot.insert(prot.end(), o.prot.begin(), o.prot.end());
+    fiber.insert(fiber.end(), o.fiber.begin(), o.fiber.end());
+    comments.append(o.comments);
+    issues.merge(o.issues);
+  }
+};
+
+static void parse_extra_rows(std::string_view text, ExtraColumns& out) {
+  auto reader = CsvReader::from_text(text);
+  std::span<const std::string_view> c;
+  ExtraView e;
+  record::RowError err;
+  while (reader.next(c)) {
+    if (!record::decode(reader, c, e, err)) {
+      out.issues.note(reader.record(), err);
+      continue;
+    }
+    out.dates.push_back(e.date.serial);
+    out.kcal.push_back(e.kcal);
+    out.prot.push_back(e.prot);
+    out.fiber.push_back(e.fiber);
+    out.comments.push(e.comment);
+  }
+}
 
-    // comment optionnel : 4 colonnes minimum
-    if (c.size() < 4) continue;  // date,kcal,prot,fiber,(comment)
+// food_extras.csv: date,kcal,prot,fiber,comment
+static std::vector<uint64_t> import_extras(const std::string& csv, const SourceStamp& src) {
+  MappedFile file(csv);
+  auto reader = CsvReader::from_text(file.data());
+  std::span<const std::string_view> header;
+  const bool header_ok = !reader.next(header) || record::check_header<ExtraView>(header);
+
+  const auto ranges = parse_ranges(reader.remaining());
+  auto parts = parse_parallel<ExtraColumns>(ranges, parse_extra_rows);
+  ExtraColumns cols = std::move(parts.front());
+  for (size_t i = 1; i < parts.size(); ++i) cols.append(parts[i]);
+  record::report<ExtraView>(std::cerr, csv, file.data(), header_ok, cols.issues);
+
+  SnapshotBuilder b(SnapshotKind::Extras, cols.dates.size());
+  b.add_i32(cols.dates);     // E_DATE
+  b.add_f64(cols.kcal);      // E_KCAL
+  b.add_f64(cols.prot);      // E_PROT
+  b.add_f64(cols.fiber);     // E_FIBER
+  b.add_str(cols.comments);  // E_COMMENT
+  return b.finish(src);
+}
 
-    Date d{};
-    if (!parse_date_yyyy_mm_dd(c[0], d)) continue;
-    if (!in_range(d, start, end)) continue;
+Snapshot load_batches_snapshot(const std::string& batches_csv) {
+  return load_or_import_snapshot(batches_csv, SnapshotKind::Batches, import_batches);
+}
 
-    double kcal  = std::stod(c[1]);
-    double prot  = std::stod(c[2]);
-    double fiber = std::stod(c[3]);
+Snapshot load_extras_snapshot(const std::string& extras_csv) {
+  return load_or_import_snapshot(extras_csv, SnapshotKind::Extras, import_extras);
+}
 
-    const auto key = format_date(d);
-    out.kcal[key]  += kcal;
-    out.prot[key]  += prot;
-    out.fiber[key] += fiber;
+DayMacros compute_daily_macros(
+  const ProductDB& db,
+  const Snapshot& batches,
+  const Snapshot& extras,
+  const Date& start,
+  int days
+) {
+  PROFILE_ZONE("compute_daily_macros");
+  using namespace snapcol;
+  DayAccumulator acc(start, days);
+
+  const auto bstart = batches.i32(B_START);
+  const auto bdays = batches.i32(B_DAYS);
+  const auto qty = batches.f64(B_QTY);
+  for (size_t i = 0; i < batches.rows(); ++i) {
+    auto p = db.find_id(batches.str(B_PRODUCT, i));
+    if (!p.has_value()) continue;
+    acc.add_batch(Date{bstart[i]}, bdays[i], db.view(*p), qty[i]);
   }
 
+  const auto edate = extras.i32(E_DATE);
+  const auto kcal = extras.f64(E_KCAL);
+  const auto prot = extras.f64(E_PROT);
+  const auto fiber = extras.f64(E_FIBER);
+  for (size_t i = 0; i < extras.rows(); ++i) {
+    acc.add_day(Date{edate[i]}, kcal[i], prot[i], fiber[i]);
+  }
 
-
-  return out;
+  return acc.finish();
 }
 
+DayMacros compute_daily_kcal_and_prot_and_fiber(
+  const ProductDB& db,
+  const std::string& batches_csv,
+  const std::string& extras_csv,
+  const Date& start,
+  int days
+) {
+  return compute_daily_macros(db, load_batches_snapshot(batches_csv),
+                              load_extras_snapshot(extras_csv), start, days);
+}
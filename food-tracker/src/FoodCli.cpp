@@ -1,25 +1,38 @@
 #include "FoodCli.hpp"
-#include "Calculator.hpp"
+#include "History.hpp"
+#include "Chart.hpp"
 #include "Csv.hpp"
 #include "ProductDB.hpp"
+#include "PlotCache.hpp"
+#include "Profile.hpp"
+#include "ProductImport.hpp"
+#include "Record.hpp"
 #include "Date.hpp"
 #include <iostream>
 #include <iomanip>
 #include <filesystem>
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <cstdlib>
 #include <cmath>
+#include <ctime>
+#include <iterator>
 #include <sstream>
+#include <utility>
 
 namespace {
 
-void print_food_help() {
-    std::cout << "Usage:\n"
+void print_food_help(std::ostream& out) {
+    out << "Usage:\n"
         << "  ./DailyApp food list\n"
         << "  ./DailyApp food add-product\n"
+        << "  ./DailyApp food import-products <file> [--threads N] [--map champ=colonne]...\n"
         << "  ./DailyApp food add-extra <date YYYY-MM-DD> <kcal> [comment]\n"
-        << "  ./DailyApp food history\n"
+        << "  ./DailyApp food history [--wait] [--from <YYYY-MM-DD>] [--to <YYYY-MM-DD>] [--last <days>]\n"
+        << "  ./DailyApp food stats [--by week|month|range] [--from <YYYY-MM-DD>] [--to <YYYY-MM-DD>] [--last <days>]\n"
+        << "  ./DailyApp food plot-status\n"
+        << "  ./DailyApp food rebuild\n"
         << "\nDraft (multi-items):\n"
         << "  ./DailyApp food draft-new <start YYYY-MM-DD> <days>\n"
         << "  ./DailyApp food draft-add <product> <qty><unit> [comment]\n"
@@ -33,79 +46,17 @@ namespace food {
 static void ensure_headers(const std::string& products,
                            const std::string& batches,
                            const std::string& extras) {
+    PROFILE_ZONE("food/ensure_headers");
     if (!file_exists(products)) {
-    append_line(products, "id,name,unit,kcal_per_100,prot_per_100,fiber_per_100,aliases");
+    append_line(products, record::header<Product>());
     }
     if (!file_exists(batches)) {
-    append_line(batches, "batch_id,start_date,days,product_id,qty,unit,comment");
+    append_line(batches, record::header<Batch>());
     }
     if (!file_exists(extras)) {
-    append_line(extras, "date,kcal,prot,fiber,comment");
+    append_line(extras, record::header<Extra>());
     }
 }
-static double round2(double x) {
-    return std::round(x * 100.0) / 100.0;
-}
-static bool same_val(double a, double b) {
-    return std::abs(round2(a) - round2(b)) < 1e-9;
-}
-
-struct DateRange { Date min{}; Date max{}; bool ok=false; };
-
-static DateRange compute_available_range(const std::string& batches_csv,
-                                         const std::string& extras_csv) {
-    DateRange r{};
-    bool have = false;
-    Date minD{}, maxD{};
-
-    // food_batches.csv: batch_id,start_date,days,product_id,qty,unit,comment
-    if (file_exists(batches_csv)) {
-        auto lines = read_lines(batches_csv);
-        for (size_t i = 1; i < lines.size(); ++i) {
-            auto c = split_csv_simple(lines[i]);
-            if (c.size() < 3) continue;
-
-            Date start{};
-            if (!parse_date_yyyy_mm_dd(c[1], start)) continue;
-
-            int days = 0;
-            try { days = std::stoi(c[2]); } catch (...) { continue; }
-            if (days <= 0) continue;
-
-            Date end = add_days(start, days - 1);
-
-            if (!have) { minD = start; maxD = end; have = true; }
-            else {
-                if (start < minD) minD = start;
-                if (maxD < end)   maxD = end;
-            }
-        }
-    }
-
-    // food_extras.csv: date,kcal,prot,comment
-    if (file_exists(extras_csv)) {
-        auto lines = read_lines(extras_csv);
-        for (size_t i = 1; i < lines.size(); ++i) {
-            auto c = split_csv_simple(lines[i]);
-            if (c.size() < 1) continue;
-
-            Date d{};
-            if (!parse_date_yyyy_mm_dd(c[0], d)) continue;
-
-            if (!have) { minD = d; maxD = d; have = true; }
-            else {
-                if (d < minD) minD = d;
-                if (maxD < d) maxD = d;
-            }
-        }
-    }
-
-    r.ok = have;
-    r.min = minD;
-    r.max = maxD;
-    return r;
-}
-
 
 static bool parse_qty_unit(const std::string& s, double& qty, std::string& unit) {
     // ex: "700g" ou "250ml"
@@ -113,7 +64,7 @@ static bool parse_qty_unit(const std::string& s, double& qty, std::string& unit)
     if (t.size() < 2) return false;
     size_t pos = t.find_first_not_of("0123456789.");
     if (pos == std::string::npos) return false;
-    qty = std::stod(t.substr(0, pos));
+    if (!parse_double(std::string_view(t).substr(0, pos), qty)) return false;
     unit = t.substr(pos);
     unit = trim(unit);
     if (unit == "ml") unit = "mL";
@@ -147,185 +98,310 @@ static bool draft_exists() {
     return std::filesystem::exists(draftPath());
 }
 
+// draft-commit différé : le draft quitte draft.csv (les commandes suivantes
+// du batch voient un draft vide) mais reste sur disque jusqu'à l'écriture.
+static bool draft_stage(std::string& staged, std::ostream& err) {
+    staged = temp_path_for(draftPath().string());
+    std::error_code ec;
+    std::filesystem::rename(draftPath(), staged, ec);
+    if (ec) err << "Draft non déplaçable: " << ec.message() << "\n";
+    return !ec;
+}
+
+// Après l'écriture des lots : drafts supprimés, ou remis en place si elle a
+// échoué (à côté si un nouveau draft a été créé entre-temps).
+static void draft_settle(const std::vector<std::string>& staged, bool written, std::ostream& err) {
+    std::error_code ec;
+    for (const auto& path : staged) {
+        if (written) {
+            std::filesystem::remove(path, ec);
+            continue;
+        }
+        if (!draft_exists()) {
+            std::filesystem::rename(path, draftPath(), ec);
+            if (!ec) {
+                err << "Draft conservé.\n";
+                continue;
+            }
+        }
+        err << "Draft conservé dans " << path << "\n";
+    }
+}
+
 struct DraftMeta { Date start{}; int days=0; };
+struct DraftItem { std::string pid; double qty=0.0; std::string unit; std::string comment; };
+
+} // namespace food
+
+// draft.csv : une ligne start_date,days puis les items product_id,qty,unit,comment
+template <>
+struct record::Schema<food::DraftMeta> {
+    static constexpr auto columns = std::tuple{
+        record::column("start_date", &food::DraftMeta::start),
+        record::column("days", &food::DraftMeta::days).checked(record::positive<int>),
+    };
+};
+
+template <>
+struct record::Schema<food::DraftItem> {
+    static constexpr auto columns = std::tuple{
+        record::column("product_id", &food::DraftItem::pid),
+        record::column("qty", &food::DraftItem::qty),
+        record::column("unit", &food::DraftItem::unit),
+        record::optional_column("comment", &food::DraftItem::comment),
+    };
+};
+
+namespace food {
 
 static bool draft_read_meta(DraftMeta& meta) {
-    auto lines = read_lines(draftPath().string());
-    if (lines.size() < 2) return false;
+    CsvReader reader(draftPath().string());
+    std::span<const std::string_view> cols;
     // line0: start_date,days
     // line1: 2026-01-17,7
-    auto cols = split_csv_simple(lines[1]);
-    if (cols.size() < 2) return false;
-    if (!parse_date_yyyy_mm_dd(cols[0], meta.start)) return false;
-    meta.days = std::stoi(cols[1]);
-    return meta.days > 0;
+    if (!reader.next(cols) || !reader.next(cols)) return false;
+    return record::decode(cols, meta);
 }
 
 static void draft_init(const Date& start, int days) {
     draft_clear();
-    const auto p = draftPath().string();
-    append_line(p, "start_date,days");
-    append_line(p, format_date(start) + "," + std::to_string(days));
-    append_line(p, "product_id,qty,unit,comment");
+    AppendBatch draft(draftPath().string());
+    draft.add(record::header<DraftMeta>());
+    draft.add(record::encode(DraftMeta{start, days}));
+    draft.add(record::header<DraftItem>());
+    draft.commit();
 }
 
 static void draft_add_line(const std::string& product_id, double qty, const std::string& unit, const std::string& comment) {
-    append_line(draftPath().string(),
-        product_id + "," + std::to_string(qty) + "," + unit + "," + comment
-    );
+    append_line(draftPath().string(), record::encode(DraftItem{product_id, qty, unit, comment}));
 }
 
-struct DraftItem { std::string pid; double qty=0.0; std::string unit; std::string comment; };
-
 static std::vector<DraftItem> draft_read_items() {
     std::vector<DraftItem> items;
-    auto lines = read_lines(draftPath().string());
+    CsvReader reader(draftPath().string());
+    std::span<const std::string_view> c;
     // header 0, meta 1, header items 2, data from 3
-    for (size_t i = 3; i < lines.size(); ++i) {
-        auto c = split_csv_simple(lines[i]);
-        if (c.size() < 3) continue;
-        DraftItem it;
-        it.pid = c[0];
-        it.qty = std::stod(c[1]);
-        it.unit = c[2];
-        if (c.size() >= 4) it.comment = c[3];
-        items.push_back(it);
+    for (int i = 0; i < 3; ++i) {
+        if (!reader.next(c)) return items;
+    }
+    DraftItem it;
+    while (reader.next(c)) {
+        if (record::decode(c, it)) items.push_back(it);
     }
     return items;
 }
-static int runFoodHistoryPlot() {
+// Cibles journalières (constantes), bandes du graphique.
+static constexpr double KCAL_MIN = 1750, KCAL_MAX = 2150;
+static constexpr double PROT_MIN = 110, PROT_MAX = 140;
+static constexpr double FIB_MIN = 25, FIB_MAX = 40;
+
+// Ancien rendu matplotlib (DAILYAPP_PLOT=python), relit food_history.csv.
+static int runFoodHistoryPlotPython(std::ostream& err) {
+    PROFILE_ZONE("plot/python subprocess");
     const std::filesystem::path root = std::filesystem::path(DAILYAPP_ROOT_DIR);
     const std::filesystem::path csv  = dataDir() / "food_history.csv";
     const std::filesystem::path out  = dataDir() / "food_history.png";
     const std::filesystem::path py   = root / "analytics" / "food_history.py";
 
     if (!std::filesystem::exists(py)) {
-        std::cerr << "[plot] Script not found: " << py << "\n";
+        err << "[plot] Script not found: " << py << "\n";
         return 127;
     }
 
+    // le script écrit à côté, l'image n'est remplacée qu'après un succès
+    // (suffixe .png : matplotlib en déduit le format)
+    const std::string tmp = temp_path_for(out.string()) + ".png";
     std::ostringstream cmd;
     cmd << "python3 "
         << "\"" << py.string() << "\""
         << " --csv " << "\"" << csv.string() << "\""
-        << " --out " << "\"" << out.string() << "\"";
+        << " --out " << "\"" << tmp << "\"";
 
     int rc = std::system(cmd.str().c_str());
-    if (rc != 0)
-        std::cerr << "[plot] analytics failed (exit code " << rc << ")\n";
+    std::error_code ec;
+    if (rc == 0) {
+        std::filesystem::rename(tmp, out, ec);
+        if (ec) {
+            err << "[plot] " << out.string() << ": " << ec.message() << "\n";
+            rc = 1;
+        }
+    } else {
+        err << "[plot] analytics failed (exit code " << rc << ")\n";
+    }
+    if (rc != 0) std::filesystem::remove(tmp, ec);
     return rc;
 }
 
-static int rebuild_food_history_csv(ProductDB& db,
-                                    const std::string& batches,
-                                    const std::string& extras,
-                                    const std::string& out_csv)
-{
-    auto range = compute_available_range(batches, extras);
-    if (!range.ok) {
-        // pas d'erreur fatale : on peut juste vider le cache ou ne rien faire
-        // je préfère ne rien faire et informer.
-        std::cerr << "No data found in food_batches.csv / food_extras.csv.\n";
-        return 1;
-    }
-
-    int days = days_between_inclusive(range.min, range.max);
-    if (days <= 0) {
-        std::cerr << "Invalid computed date range.\n";
-        return 2;
-    }
-
-    auto per = compute_daily_kcal_and_prot_and_fiber(db, batches, extras, range.min, days);
+// food_history.png / .svg rendus en C++ depuis le snapshot déjà chargé,
+// sautés si food_history.plot a l'empreinte des mêmes entrées. Sans `wait`,
+// le rendu part en arrière-plan (cf. food plot-status).
+static int runFoodHistoryPlot(const Snapshot& history, bool wait, std::ostream& out, std::ostream& err) {
+    const std::filesystem::path png = dataDir() / "food_history.png";
+
+    PlotJob job;
+    job.sidecar = (dataDir() / "food_history.plot").string();
+
+    if (const char* mode = std::getenv("DAILYAPP_PLOT"); mode && std::string_view(mode) == "python") {
+        Fingerprint key;
+        key.add("python");
+        fingerprint_file(key, (dataDir() / "food_history.csv").string());
+        fingerprint_file(key, (std::filesystem::path(DAILYAPP_ROOT_DIR) / "analytics" / "food_history.py").string());
+        job.key = key.value();
+        job.outputs = {png.string()};
+        job.render = [](std::ostream& e) { return runFoodHistoryPlotPython(e) == 0; };
+    } else {
+        using namespace snapcol;
+        const auto dates = history.i32(H_DATE);
+        const auto kcals = history.f64(H_KCAL);
+        const auto prots = history.f64(H_PROT);
+        const auto fibers = history.f64(H_FIBER);
+
+        Chart chart;
+        chart.title = "Daily intake vs targets";
+        chart.dual_axis = true;
+        chart.legend = true;
+        chart.y[0] = {"", 0, 2500};
+        chart.y[1] = {"", 0, 170};
+        chart.bands = {{KCAL_MIN, KCAL_MAX, chart_colors::Red, 0.08, 0},
+                       {PROT_MIN, PROT_MAX, chart_colors::Blue, 0.08, 1},
+                       {FIB_MIN, FIB_MAX, chart_colors::Green, 0.08, 1}};
+        chart.series = {{"Energy (kcal)", {}, {}, chart_colors::Red, 0, false, Marker::None},
+                        {"Protein (g)", {}, {}, chart_colors::Blue, 1, true, Marker::Circle},
+                        {"Fiber (g)", {}, {}, chart_colors::Green, 1, true, Marker::Cross}};
+
+        // jours vides masqués, comme dans le script
+        for (size_t i = 0; i < history.rows(); ++i) {
+            if (kcals[i] == 0.0 && prots[i] == 0.0 && fibers[i] == 0.0) continue;
+            const double v[3] = {kcals[i], prots[i], fibers[i]};
+            for (int k = 0; k < 3; ++k) {
+                chart.series[k].days.push_back(dates[i]);
+                chart.series[k].values.push_back(v[k]);
+            }
+        }
+        if (!chart_has_data(chart)) {
+            err << "[plot] food_history.csv is empty, nothing to plot.\n";
+            return 1;
+        }
 
-    std::ofstream out(out_csv, std::ios::trunc);
-    if (!out) {
-        std::cerr << "Cannot write: " << out_csv << "\n";
-        return 3;
+        const std::string svg = (dataDir() / "food_history.svg").string();
+        job.key = chart_fingerprint(chart);
+        job.outputs = {png.string(), svg};
+        // le job peut survivre à la commande (worker) : tout est copié
+        job.render = [chart = std::move(chart), png = png.string(), svg](std::ostream& e) {
+            if (write_chart_png(chart, png) && write_chart_svg(chart, svg)) return true;
+            e << "[plot] cannot write " << png << " / " << svg << "\n";
+            return false;
+        };
     }
 
-    out << "date,kcal,protein,fiber\n";
-    for (const auto& [date_str, kcal] : per.kcal) {
-        double prot  = per.prot[date_str];
-        double fiber = per.fiber[date_str];
-        out << date_str << "," << kcal << "," << prot << "," << fiber << "\n";
+    switch (wait ? run_plot(job, err) : submit_plot(std::move(job))) {
+        case PlotStatus::Hit:      out << "✔ plot à jour (cache): " << png << "\n"; return 0;
+        case PlotStatus::Rendered: out << "✔ plot updated: " << png << "\n"; return 0;
+        case PlotStatus::Queued:   out << "… plot en arrière-plan: " << png << " (food plot-status)\n"; return 0;
+        case PlotStatus::Failed:   break;
     }
-    return 0;
+    return 1;
 }
-static int print_grouped_history_from_csv(const std::string& csv_path) {
-    if (!file_exists(csv_path)) {
-        std::cerr << "Missing cache: " << csv_path << "\n"
-                  << "Run a write command (add-extra / draft-commit) first.\n";
+
+static int printPlotStatus(std::ostream& out) {
+    PlotState st;
+    if (!read_plot_state((dataDir() / "food_history.plot").string(), st)) {
+        out << "Aucun plot (lancer: food history)\n";
         return 1;
     }
+    const long long age = static_cast<long long>(std::time(nullptr)) - st.updated;
+    out << "food_history.png: " << st.state << " (il y a " << age << " s)\n";
+    if (!st.message.empty()) out << "  " << st.message << "\n";
+    return st.state == "failed" ? 1 : 0;
+}
 
-    auto lines = read_lines(csv_path);
-    if (lines.size() < 2) {
-        std::cout << "Historique vide.\n";
-        return 0;
+// --- Session ---
+
+Session::Session()
+    : products_csv_((dataDir() / "food_products.csv").string()),
+      batches_csv_((dataDir() / "food_batches.csv").string()),
+      extras_csv_((dataDir() / "food_extras.csv").string()),
+      history_csv_((dataDir() / "food_history.csv").string()) {}
+
+std::shared_ptr<const ProductDB> Session::products() {
+    std::lock_guard lock(mutex_);
+    const auto stamp = stamp_of(products_csv_);
+    if (!db_ || stamp != db_stamp_) {
+        auto db = std::make_shared<ProductDB>();
+        db->load(products_csv_);
+        db_ = std::move(db);
+        db_stamp_ = stamp;
     }
+    return db_;
+}
 
-    bool started = false;
-    std::string grp_start, grp_end;
-    double grp_kcal = 0.0, grp_prot = 0.0, grp_fiber = 0.0;
-
-    auto flush_group = [&]() {
-        if (!started) return;
-        if (same_val(grp_kcal, 0.0) && same_val(grp_prot, 0.0) && same_val(grp_fiber, 0.0)) return;
-
-        if (grp_start == grp_end) {
-            std::cout << grp_start << " : " << round2(grp_kcal)
-                      << " kcal | " << round2(grp_prot) << " g prot | " << round2(grp_fiber) << " g fiber\n";
-        } else {
-            std::cout << grp_start << " -> " << grp_end << " : " << round2(grp_kcal)
-                      << " kcal | " << round2(grp_prot) << " g prot | " << round2(grp_fiber) << " g fiber\n";
-        }
-    };
-
-    bool have_prev = false;
-    Date prev{};
+std::shared_ptr<const Snapshot> Session::history() {
+    std::lock_guard lock(mutex_);
+    const auto stamp = stamp_of(history_csv_);
+    if (!stamp.ok) return nullptr;
+    if (!history_ || stamp != history_stamp_) {
+        history_ = std::make_shared<const Snapshot>(load_history_snapshot(history_csv_));
+        history_stamp_ = stamp;
+    }
+    return history_;
+}
 
-    for (size_t i = 1; i < lines.size(); ++i) { // skip header
-        auto c = split_csv_simple(lines[i]);
-        if (c.size() < 4) continue;
+std::shared_ptr<const Snapshot> Session::history(const DateRange& range) {
+    if (!range.bounded()) return history();
+    std::lock_guard lock(mutex_);
+    const auto stamp = stamp_of(history_csv_);
+    if (!stamp.ok) return nullptr;
+    if (history_ && stamp == history_stamp_) return history_;
+    return std::make_shared<const Snapshot>(load_history_range(history_csv_, range));
+}
 
-        const std::string& date_str = c[0];
-        double kcal  = std::stod(c[1]);
-        double prot  = std::stod(c[2]);
-        double fiber = std::stod(c[3]);
+void Session::defer_writes() {
+    if (!pending_) pending_.emplace();
+}
 
-        Date cur{};
-        if (!parse_date_yyyy_mm_dd(date_str, cur)) continue;
+PendingWrites* Session::pending() {
+    return pending_ ? &*pending_ : nullptr;
+}
 
-        bool consecutive = false;
-        if (have_prev) {
-            Date expected = add_days(prev, 1);
-            consecutive = (cur == expected);
-        }
+int Session::flush_writes(std::ostream& err) {
+    if (!pending_ || (pending_->batch_rows.empty() && pending_->extra_rows.empty())) return 0;
+    PROFILE_ZONE("food/flush writes");
+    PendingWrites w = std::exchange(*pending_, PendingWrites{});
 
-        if (!started) {
-            started = true;
-            grp_start = grp_end = date_str;
-            grp_kcal = kcal; grp_prot = prot; grp_fiber = fiber;
-        } else {
-            if (consecutive && same_val(kcal, grp_kcal) && same_val(prot, grp_prot) && same_val(fiber, grp_fiber)) {
-                grp_end = date_str;
-            } else {
-                flush_group();
-                grp_start = grp_end = date_str;
-                grp_kcal = kcal; grp_prot = prot; grp_fiber = fiber;
-            }
-        }
+    const bool history_ok = food_history_is_current(history_csv_, batches_csv_, extras_csv_);
 
-        prev = cur;
-        have_prev = true;
+    AppendBatch batches(batches_csv_, /*durable=*/true);
+    for (const auto& row : w.batch_rows) batches.add(row);
+    AppendBatch extras(extras_csv_, /*durable=*/true);
+    for (const auto& row : w.extra_rows) extras.add(row);
+    if (!batches.commit() || !extras.commit()) {
+        err << "Écriture de food_batches.csv / food_extras.csv impossible.\n";
+        draft_settle(w.drafts, false, err);
+        return 1;
     }
+    draft_settle(w.drafts, true, err);
 
-    flush_group();
-    return 0;
+    const auto db = products();
+    if (history_ok) return update_food_history_csv(*db, w.batches, w.extras, batches_csv_, extras_csv_, history_csv_, err);
+    return rebuild_food_history_csv(*db, batches_csv_, extras_csv_, history_csv_, err);
+}
+
+bool is_read_only(std::span<const std::string_view> args) {
+    if (args.empty()) return true;
+    const std::string_view cmd = args[0];
+    return cmd == "--help" || cmd == "-h" || cmd == "list" || cmd == "history" || cmd == "draft-summary" ||
+           cmd == "plot-status" || cmd == "stats";
 }
+
 int run(std::span<const std::string_view> args) {
+    Session session;
+    return run(session, args, std::cout, std::cerr);
+}
+
+int run(Session& session, std::span<const std::string_view> args, std::ostream& out, std::ostream& err) {
+    PROFILE_ZONE("food::run");
     if (args.empty() || args[0] == "--help" || args[0] == "-h") {
-        print_food_help();
+        print_food_help(out);
         return 0;
     }
 
@@ -338,16 +414,21 @@ int run(std::span<const std::string_view> args) {
 
     ensure_headers(PRODUCTS, BATCHES, EXTRAS);
 
-    ProductDB db;
-    db.load(PRODUCTS);
+    // le catalogue n'est chargé que par les commandes qui s'en servent
+    const bool needs_products = !(cmd == "draft-new" || cmd == "draft-clear" || cmd == "history" ||
+                                  cmd == "plot-status" || cmd == "stats");
+    auto products = needs_products ? session.products() : std::make_shared<const ProductDB>();
+    const ProductDB& db = *products;
 
     if (cmd == "list") {
-        auto products = db.products; // copie
+        std::vector<ProductView> products;
+        products.reserve(db.size());
+        for (size_t i = 0; i < db.size(); ++i) products.push_back(db.view(i));
         std::sort(products.begin(), products.end(),
-                  [](const Product& a, const Product& b) { return a.id < b.id; });
+                  [](const ProductView& a, const ProductView& b) { return a.id < b.id; });
 
         for (const auto& p : products) {
-            std::cout << std::left
+            out << std::left
                       << std::setw(14) << p.id
                       << std::setw(22) << p.name
                       << std::setw(8)  << p.kcal_per_100
@@ -362,79 +443,157 @@ int run(std::span<const std::string_view> args) {
     }
 
     if (cmd == "add-product") {
-        db.add_interactive(PRODUCTS);
+        if (!db.add_interactive(PRODUCTS, std::cin, out)) {
+            err << "Nombre invalide, produit non ajouté. Exemple: 265 ou 12.5\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (cmd == "import-products") {
+        if (args.size() < 2) {
+            err << "import-products <file> [--threads N] [--map champ=colonne]...\n";
+            return 1;
+        }
+        ProductImportOptions opt;
+        for (size_t i = 2; i < args.size(); ++i) {
+            if (args[i] == "--threads" && i + 1 < args.size()) {
+                int n = 0;
+                if (!parse_int(args[++i], n) || n < 0) { err << "Bad --threads\n"; return 1; }
+                opt.threads = static_cast<unsigned>(n);
+            } else if (args[i] == "--map" && i + 1 < args.size()) {
+                const std::string_view m = args[++i];
+                const size_t eq = m.find('=');
+                if (eq == std::string_view::npos) { err << "--map champ=colonne\n"; return 1; }
+                opt.columns.emplace_back(std::string(m.substr(0, eq)), std::string(m.substr(eq + 1)));
+            } else {
+                err << "Option inconnue: " << args[i] << "\n";
+                return 1;
+            }
+        }
+
+        ProductImportReport report;
+        std::string error;
+        if (!import_products_file(db, PRODUCTS, std::string(args[1]), opt, report, error)) {
+            err << "Import impossible: " << error << "\n";
+            return 1;
+        }
+
+        // index reconstruits une seule fois, sur le catalogue complet
+        const auto t0 = std::chrono::steady_clock::now();
+        products = session.products();
+        const double index_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        out << "✔ " << report.added << " produits importés ("
+                  << report.rows << " lignes, " << report.duplicates << " doublons, "
+                  << report.invalid << " invalides)\n"
+                  << std::fixed << std::setprecision(2)
+                  << "  parse: " << report.seconds << " s ("
+                  << std::setprecision(0) << (report.seconds > 0 ? report.rows / report.seconds : 0.0)
+                  << " lignes/s), index: " << std::setprecision(2) << index_s << " s\n";
         return 0;
     }
 
     if (cmd == "draft-new") {
-        if (args.size() != 3) { std::cerr << "draft-new <start> <days>\n"; return 1; }
+        if (args.size() != 3) { err << "draft-new <start> <days>\n"; return 1; }
         Date start{};
-        if (!parse_date_yyyy_mm_dd(std::string(args[1]), start)) { std::cerr << "Bad date\n"; return 1; }
+        if (!parse_date_yyyy_mm_dd(std::string(args[1]), start)) { err << "Bad date\n"; return 1; }
         int days = 0;
-        try { days = std::stoi(std::string(args[2])); } catch (...) { return 1; }
-        if (days <= 0) { std::cerr << "days must be > 0\n"; return 1; }
+        if (!parse_int(args[2], days) || days <= 0) { err << "days must be > 0\n"; return 1; }
 
         draft_init(start, days);
-        std::cout << "✔ draft créé (" << format_date(start) << ", " << days << " jours)\n";
+        out << "✔ draft créé (" << format_date(start) << ", " << days << " jours)\n";
         return 0;
     }
 
     if (cmd == "add-extra") {
         // add-extra <date> <kcal> [comment...]
-        if (args.size() < 3) { std::cerr << "add-extra <date> <kcal> [comment]\n"; return 1; }
+        if (args.size() < 3) { err << "add-extra <date> <kcal> [comment]\n"; return 1; }
 
         Date d{};
-        if (!parse_date_yyyy_mm_dd(std::string(args[1]), d)) { std::cerr << "Bad date\n"; return 1; }
+        if (!parse_date_yyyy_mm_dd(std::string(args[1]), d)) { err << "Bad date\n"; return 1; }
 
         double kcal = 0.0;
-        try { kcal = std::stod(std::string(args[2])); } catch (...) { return 1; }
+        if (!parse_double(args[2], kcal)) { err << "Bad kcal\n"; return 1; }
 
         std::string comment = (args.size() >= 4) ? join_rest_args(args, 3) : "";
 
         // food_extras.csv: date,kcal,prot,fiber,comment
-        append_line(EXTRAS, format_date(d) + "," + std::to_string(kcal) + ",0,0," + comment);
+        Extra e{d, kcal, 0.0, 0.0, comment};
+        std::string row = record::encode(e);
+
+        if (auto* pending = session.pending()) {
+            pending->extra_rows.push_back(std::move(row));
+            pending->extras.push_back(std::move(e));
+            out << "✔ extra ajouté\n";
+            return 0;
+        }
 
-        std::cout << "✔ extra ajouté\n";
         const auto HISTORY_CSV = (dataDir() / "food_history.csv").string();
-        rebuild_food_history_csv(db, BATCHES, EXTRAS, HISTORY_CSV);
+        const bool history_ok = food_history_is_current(HISTORY_CSV, BATCHES, EXTRAS);
+
+        append_line(EXTRAS, row);
+
+        out << "✔ extra ajouté\n";
+        if (history_ok) {
+            update_food_history_csv(db, {}, {e}, BATCHES, EXTRAS, HISTORY_CSV, err);
+        } else {
+            rebuild_food_history_csv(db, BATCHES, EXTRAS, HISTORY_CSV, err);
+        }
         return 0;
     }
 
     if (cmd == "draft-add") {
         // draft-add <product> <qty><unit> [comment...]
-        if (!draft_exists()) { std::cerr << "Aucun draft. Fais: draft-new <start> <days>\n"; return 1; }
-        if (args.size() < 3) { std::cerr << "draft-add <product> <qty><unit> [comment]\n"; return 1; }
+        if (!draft_exists()) { err << "Aucun draft. Fais: draft-new <start> <days>\n"; return 1; }
+        if (args.size() < 3) { err << "draft-add <product> <qty><unit> [comment]\n"; return 1; }
 
         std::string prod_in = std::string(args[1]);
         double qty = 0.0;
         std::string unit;
-        if (!parse_qty_unit(std::string(args[2]), qty, unit)) { std::cerr << "Bad qty/unit (ex: 700g, 250mL)\n"; return 1; }
-
-        auto prod = db.resolve(prod_in);
-        if (!prod) { std::cerr << "Produit introuvable: " << prod_in << "\n"; return 1; }
+        if (!parse_qty_unit(std::string(args[2]), qty, unit)) { err << "Bad qty/unit (ex: 700g, 250mL)\n"; return 1; }
+
+        auto idx = db.resolve(prod_in);
+        if (!idx) {
+            // faute de frappe : un meilleur candidat net est retenu, sinon on liste
+            const auto matches = db.fuzzy(prod_in);
+            if (matches.empty()) { err << "Produit introuvable: " << prod_in << "\n"; return 1; }
+            if (matches.size() == 1 || matches[1].distance > matches[0].distance) {
+                idx = matches[0].product;
+                out << "→ " << prod_in << " interprété comme " << db.view(*idx).id << "\n";
+            } else {
+                err << "Produit ambigu: " << prod_in << ". Vouliez-vous dire :\n";
+                for (const auto& m : matches) {
+                    const auto v = db.view(m.product);
+                    err << "  " << v.id << " | " << v.name << "\n";
+                }
+                return 1;
+            }
+        }
+        const std::string pid(db.view(*idx).id);
 
         std::string comment = (args.size() >= 4) ? join_rest_args(args, 3) : "";
-        draft_add_line(prod->id, qty, unit, comment);
-        std::cout << "✔ ajouté au draft: " << prod->id << " " << qty << unit << "\n";
+        draft_add_line(pid, qty, unit, comment);
+        out << "✔ ajouté au draft: " << pid << " " << qty << unit << "\n";
         return 0;
     }
 
     if (cmd == "draft-summary") {
-        if (!draft_exists()) { std::cerr << "Aucun draft.\n"; return 1; }
+        if (!draft_exists()) { err << "Aucun draft.\n"; return 1; }
 
         DraftMeta meta{};
-        if (!draft_read_meta(meta)) { std::cerr << "Draft invalide.\n"; return 1; }
+        if (!draft_read_meta(meta)) { err << "Draft invalide.\n"; return 1; }
 
         auto items = draft_read_items();
-        if (items.empty()) { std::cout << "Draft vide (aucun item).\n"; return 0; }
+        if (items.empty()) { out << "Draft vide (aucun item).\n"; return 0; }
 
         double total_week = 0.0, prot_week = 0.0, fiber_week = 0.0;
 
-        std::cout << "Draft: " << format_date(meta.start) << " sur " << meta.days << " jours\n";
+        out << "Draft: " << format_date(meta.start) << " sur " << meta.days << " jours\n";
         for (const auto& it : items) {
             auto p = db.get_by_id(it.pid);
             if (!p) {
-                std::cout << "  ⚠ inconnu: " << it.pid << " (ignoré)\n";
+                out << "  ⚠ inconnu: " << it.pid << " (ignoré)\n";
                 continue;
             }
             double kcal_total  = it.qty * p->kcal_per_100 / 100.0;
@@ -445,7 +604,7 @@ int run(std::span<const std::string_view> args) {
             prot_week  += prot_total;
             fiber_week += fiber_total;
 
-            std::cout << "  " << p->id << " (" << p->name << "): "
+            out << "  " << p->id << " (" << p->name << "): "
                       << kcal_total << " kcal total  -> "
                       << (kcal_total / (double)meta.days) << " kcal/j ; "
                       << prot_total << " prot total  -> "
@@ -454,65 +613,149 @@ int run(std::span<const std::string_view> args) {
                       << (fiber_total / (double)meta.days) << " g fiber/j\n";
         }
 
-        std::cout << "Total draft: " << total_week << " kcal ; " << prot_week << " g prot ; " << fiber_week << " g fiber\n";
-        std::cout << "Moyenne: " << (total_week / (double)meta.days) << " kcal/j ; "
+        out << "Total draft: " << total_week << " kcal ; " << prot_week << " g prot ; " << fiber_week << " g fiber\n";
+        out << "Moyenne: " << (total_week / (double)meta.days) << " kcal/j ; "
                   << (prot_week / (double)meta.days) << " g prot/j ; "
                   << (fiber_week / (double)meta.days) << " g fiber/j\n";
         return 0;
     }
 
     if (cmd == "draft-commit") {
-        if (!draft_exists()) { std::cerr << "Aucun draft.\n"; return 1; }
+        if (!draft_exists()) { err << "Aucun draft.\n"; return 1; }
 
         DraftMeta meta{};
-        if (!draft_read_meta(meta)) { std::cerr << "Draft invalide.\n"; return 1; }
+        if (!draft_read_meta(meta)) { err << "Draft invalide.\n"; return 1; }
 
         auto items = draft_read_items();
-        if (items.empty()) { std::cerr << "Draft vide.\n"; return 1; }
+        if (items.empty()) { err << "Draft vide.\n"; return 1; }
 
+        std::vector<std::string> lines;
+        std::vector<Batch> added;
         int k = 1;
         for (const auto& it : items) {
             std::string batch_id = format_date(meta.start) + "_" + it.pid + "_" +
                                    (k < 10 ? "0" : "") + std::to_string(k);
 
-            append_line(BATCHES,
-                batch_id + "," + format_date(meta.start) + "," + std::to_string(meta.days) + "," +
-                it.pid + "," + std::to_string(it.qty) + "," + it.unit + "," + it.comment
-            );
+            added.push_back(Batch{batch_id, meta.start, meta.days, it.pid, it.qty,
+                                  parse_unit(it.unit), it.comment});
+            lines.push_back(record::encode(added.back()));
             k++;
         }
 
+        if (auto* pending = session.pending()) {
+            std::string staged;
+            if (!draft_stage(staged, err)) return 1;
+            pending->drafts.push_back(std::move(staged));
+            std::move(lines.begin(), lines.end(), std::back_inserter(pending->batch_rows));
+            std::move(added.begin(), added.end(), std::back_inserter(pending->batches));
+            out << "✔ draft commit dans food_batches.csv (" << (k-1) << " items)\n";
+            return 0;
+        }
+
         const auto HISTORY_CSV = (dataDir() / "food_history.csv").string();
-        rebuild_food_history_csv(db, BATCHES, EXTRAS, HISTORY_CSV);
+        const bool history_ok = food_history_is_current(HISTORY_CSV, BATCHES, EXTRAS);
+
+        // tout le draft part en une seule écriture durable (ou pas du tout)
+        AppendBatch rows(BATCHES, /*durable=*/true);
+        for (const auto& line : lines) rows.add(line);
+        if (!rows.commit()) {
+            err << "Écriture de food_batches.csv impossible, draft conservé.\n";
+            return 1;
+        }
+
+        if (history_ok) update_food_history_csv(db, added, {}, BATCHES, EXTRAS, HISTORY_CSV, err);
+        else rebuild_food_history_csv(db, BATCHES, EXTRAS, HISTORY_CSV, err);
 
         draft_clear();
-        std::cout << "✔ draft commit dans food_batches.csv (" << (k-1) << " items)\n";
+        out << "✔ draft commit dans food_batches.csv (" << (k-1) << " items)\n";
         return 0;
     }
 
     if (cmd == "draft-clear") {
         draft_clear();
-        std::cout << "✔ draft supprimé\n";
+        out << "✔ draft supprimé\n";
+        return 0;
+    }
+
+    if (cmd == "rebuild") {
+        if (int rc = session.flush_writes(err); rc != 0) return rc;
+        const auto HISTORY_CSV = (dataDir() / "food_history.csv").string();
+        int rc = rebuild_food_history_csv(db, BATCHES, EXTRAS, HISTORY_CSV, err);
+        if (rc != 0) return rc;
+        out << "✔ food_history.csv recalculé\n";
         return 0;
     }
 
+    if (cmd == "plot-status") {
+        return printPlotStatus(out);
+    }
+
     if (cmd == "history") {
+        bool wait = false;
+        DateRange range;
+        for (size_t i = 1; i < args.size(); ++i) {
+            const RangeArg r = parse_range_arg(args, i, range);
+            if (r == RangeArg::Invalid) {
+                err << "Plage invalide. Exemple: --from 2026-01-01 --to 2026-01-31 ou --last 14\n";
+                return 2;
+            }
+            if (r == RangeArg::None) {
+                if (args[i] != "--wait") { print_food_help(out); return 1; }
+                wait = true;
+            }
+        }
+
+        if (int rc = session.flush_writes(err); rc != 0) return rc;
         const auto HISTORY_CSV = (dataDir() / "food_history.csv").string();
 
-        int prc = print_grouped_history_from_csv(HISTORY_CSV);
+        const auto history = session.history(range);
+        if (!history) {
+            err << "Missing cache: " << HISTORY_CSV << "\n"
+                << "Run a write command (add-extra / draft-commit) first.\n";
+            return 1;
+        }
+        int prc = print_grouped_history(*history, out, range);
         if (prc != 0) return prc;
 
-        int rc = runFoodHistoryPlot();
-        if (rc != 0) {
-            return rc; // comme tu voulais
+        // plage : requête de consultation, le graphique reste celui de tout l'historique
+        if (range.bounded()) return 0;
+        return runFoodHistoryPlot(*history, wait, out, err);
+    }
+
+    if (cmd == "stats") {
+        if (int rc = session.flush_writes(err); rc != 0) return rc;
+        StatsPeriod by = StatsPeriod::Range;
+        DateRange range;
+        for (size_t i = 1; i < args.size(); ++i) {
+            const RangeArg r = parse_range_arg(args, i, range);
+            if (r == RangeArg::Ok) continue;
+            if (r == RangeArg::None && args[i] == "--by" && i + 1 < args.size()) {
+                const std::string_view v = args[++i];
+                if (v == "week") by = StatsPeriod::Week;
+                else if (v == "month") by = StatsPeriod::Month;
+                else if (v == "range") by = StatsPeriod::Range;
+                else { print_food_help(out); return 1; }
+                continue;
+            }
+            if (r == RangeArg::Invalid) {
+                err << "Plage invalide. Exemple: --from 2026-01-01 --to 2026-01-31 ou --last 14\n";
+                return 2;
+            }
+            print_food_help(out);
+            return 1;
         }
 
-        std::cout << "✔ plot updated: " << (dataDir() / "food_history.png") << "\n";
-        return 0;
+        const auto history = session.history(range);
+        if (!history) {
+            err << "Missing cache: " << (dataDir() / "food_history.csv").string() << "\n"
+                << "Run a write command (add-extra / draft-commit) first.\n";
+            return 1;
+        }
+        return print_history_stats(*history, out, range, by);
     }
 
-    std::cerr << "Unknown food command: " << cmd << "\n";
-    print_food_help();
+    err << "Unknown food command: " << cmd << "\n";
+    print_food_help(out);
     return 2;
 }
 
@@ -0,0 +1,501 @@
+#include "History.hpp"
+#include "Calculator.hpp"
+#include "ProductDB.hpp"
+#include "Csv.hpp"
+#include "Snapshot.hpp"
+#include "Date.hpp"
+#include "Profile.hpp"
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cmath>
+#include <cstdio>
+
+static constexpr const char* HISTORY_HEADER = "date,kcal,protein,fiber";
+
+static double round2(double x) {
+    return std::round(x * 100.0) / 100.0;
+}
+static bool same_val(double a, double b) {
+    return std::abs(round2(a) - round2(b)) < 1e-9;
+}
+
+struct AvailableRange { Date min{}; Date max{}; bool ok=false; };
+
+static AvailableRange compute_available_range(const Snapshot& batches, const Snapshot& extras) {
+    using namespace snapcol;
+    AvailableRange r{};
+    bool have = false;
+    Date minD{}, maxD{};
+
+    auto extend = [&](const Date& a, const Date& b) {
+        if (!have) { minD = a; maxD = b; have = true; return; }
+        if (a < minD) minD = a;
+        if (maxD < b) maxD = b;
+    };
+
+    // food_batches.csv: batch_id,start_date,days,product_id,qty,unit,comment
+    const auto bstart = batches.i32(B_START);
+    const auto bdays = batches.i32(B_DAYS);
+    for (size_t i = 0; i < batches.rows(); ++i) {
+        const Date start{bstart[i]};
+        extend(start, add_days(start, bdays[i] - 1));
+    }
+
+    // food_extras.csv: date,kcal,prot,fiber,comment
+    for (int32_t d : extras.i32(E_DATE)) extend(Date{d}, Date{d});
+
+    r.ok = have;
+    r.min = minD;
+    r.max = maxD;
+    return r;
+}
+
+// Les valeurs sont écrites en aller-retour exact (plus courte représentation)
+// pour qu'un patch incrémental reparte des mêmes doubles qu'un recalcul complet.
+static void append_history_row(std::string& out, const Date& d,
+                               double kcal, double prot, double fiber) {
+    char date[10];
+    format_date_to(d, date);
+    out.append(date, sizeof(date));
+    out += ',';
+    append_double(out, kcal);
+    out += ',';
+    append_double(out, prot);
+    out += ',';
+    append_double(out, fiber);
+    out += '\n';
+}
+
+int rebuild_food_history_csv(const ProductDB& db,
+                             const std::string& batches,
+                             const std::string& extras,
+                             const std::string& out_csv,
+                             std::ostream& err)
+{
+    PROFILE_ZONE("rebuild_food_history_csv");
+    const auto bsnap = load_batches_snapshot(batches);
+    const auto esnap = load_extras_snapshot(extras);
+    AvailableRange range;
+    {
+        PROFILE_ZONE("rebuild/range scan");
+        range = compute_available_range(bsnap, esnap);
+    }
+    if (!range.ok) {
+        // pas d'erreur fatale : on peut juste vider le cache ou ne rien faire
+        // je préfère ne rien faire et informer.
+        err << "No data found in food_batches.csv / food_extras.csv.\n";
+        return 1;
+    }
+
+    int days = days_between_inclusive(range.min, range.max);
+    if (days <= 0) {
+        err << "Invalid computed date range.\n";
+        return 2;
+    }
+
+    auto per = compute_daily_macros(db, bsnap, esnap, range.min, days);
+
+    PROFILE_ZONE("rebuild/write");
+    std::ofstream out(out_csv, std::ios::trunc | std::ios::binary);
+    if (!out) {
+        err << "Cannot write: " << out_csv << "\n";
+        return 3;
+    }
+
+    std::string buf = std::string(HISTORY_HEADER) + "\n";
+    buf.reserve(per.size() * 40 + buf.size());
+    for (size_t i = 0; i < per.size(); ++i) {
+        append_history_row(buf, per.date_at(i), per.kcal[i], per.prot[i], per.fiber[i]);
+    }
+    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    return 0;
+}
+
+bool food_history_is_current(const std::string& history_csv,
+                             const std::string& batches,
+                             const std::string& extras) {
+    std::error_code ec;
+    const auto h = std::filesystem::last_write_time(history_csv, ec);
+    if (ec) return false;
+    for (const auto* src : {&batches, &extras}) {
+        const auto t = std::filesystem::last_write_time(*src, ec);
+        if (ec || h < t) return false;
+    }
+    return true;
+}
+
+// Offset du début de la n-ième ligne en partant de la fin (n >= 1).
+// Le fichier doit se terminer par '\n'. Retourne -1 si introuvable.
+static long long offset_of_nth_last_line(std::ifstream& in, long long size, long long n) {
+    constexpr long long BLOCK = 64 * 1024;
+    std::string block;
+    long long seen = 0;
+    long long end = size - 1; // on ignore le '\n' final
+    while (end > 0) {
+        const long long begin = std::max(0LL, end - BLOCK);
+        block.resize(static_cast<size_t>(end - begin));
+        in.seekg(begin);
+        if (!in.read(block.data(), static_cast<std::streamsize>(block.size()))) return -1;
+        for (long long i = static_cast<long long>(block.size()) - 1; i >= 0; --i) {
+            if (block[static_cast<size_t>(i)] == '\n' && ++seen == n) return begin + i + 1;
+        }
+        end = begin;
+    }
+    return seen == n - 1 ? 0 : -1;
+}
+
+static bool parse_history_row(std::span<const std::string_view> c, Date& d,
+                              double& kcal, double& prot, double& fiber) {
+    return c.size() >= 4 && parse_date_yyyy_mm_dd(c[0], d) &&
+           parse_double(c[1], kcal) && parse_double(c[2], prot) && parse_double(c[3], fiber);
+}
+
+static bool parse_history_row(std::string_view line, Date& d,
+                              double& kcal, double& prot, double& fiber) {
+    std::vector<std::string_view> c;
+    std::string scratch;
+    split_csv_fields(line, c, scratch);
+    return parse_history_row(c, d, kcal, prot, fiber);
+}
+
+// Tente le patch ; false si le fichier ne s'y prête pas (absent, non dense,
+// date touchée avant le début de l'historique...).
+static bool patch_food_history_csv(const ProductDB& db,
+                                   const std::vector<Batch>& new_batches,
+                                   const std::vector<Extra>& new_extras,
+                                   const std::string& out_csv) {
+    // plage touchée par les nouvelles lignes
+    bool have = false;
+    Date lo{}, hi{};
+    auto touch = [&](const Date& a, const Date& b) {
+        if (!have) { lo = a; hi = b; have = true; return; }
+        if (a < lo) lo = a;
+        if (hi < b) hi = b;
+    };
+    for (const auto& b : new_batches) {
+        if (b.days > 0) touch(b.start, add_days(b.start, b.days - 1));
+    }
+    for (const auto& e : new_extras) touch(e.date, e.date);
+    if (!have) return true;
+
+    std::ifstream in(out_csv, std::ios::binary);
+    if (!in) return false;
+    std::string header, first_row;
+    if (!std::getline(in, header) || header != HISTORY_HEADER) return false;
+    if (!std::getline(in, first_row)) return false;
+
+    Date first{}, last{};
+    double k = 0, p = 0, f = 0;
+    if (!parse_history_row(first_row, first, k, p, f)) return false;
+    if (lo < first) return false; // il faudrait insérer en tête
+
+    in.clear();
+    in.seekg(0, std::ios::end);
+    const long long size = in.tellg();
+    {
+        char c = 0;
+        in.seekg(size - 1);
+        if (!in.get(c) || c != '\n') return false;
+    }
+
+    const long long last_off = offset_of_nth_last_line(in, size, 1);
+    if (last_off < 0) return false;
+    std::string last_row;
+    in.clear();
+    in.seekg(last_off);
+    if (!std::getline(in, last_row) || !parse_history_row(last_row, last, k, p, f)) return false;
+
+    // fichier dense : la ligne de `from` est à (last - from + 1) lignes de la fin
+    const Date from = (last < lo) ? add_days(last, 1) : lo;
+    long long offset = size;
+    if (!(last < from)) {
+        offset = offset_of_nth_last_line(in, size, days_between_inclusive(from, last));
+        if (offset < 0) return false;
+    }
+
+    // ancienne fin de fichier (+ jours vides ajoutés si la plage s'étend)
+    const Date to = (hi < last) ? last : hi;
+    const int span = days_between_inclusive(from, to);
+    DayAccumulator acc(from, span);
+    std::string old_tail(static_cast<size_t>(size - offset), '\0');
+    in.clear();
+    in.seekg(offset);
+    if (!in.read(old_tail.data(), static_cast<std::streamsize>(old_tail.size()))) return false;
+    auto reader = CsvReader::from_text(old_tail);
+    std::span<const std::string_view> row;
+    Date expected = from;
+    while (reader.next(row)) {
+        Date d{};
+        if (!parse_history_row(row, d, k, p, f) || !(d == expected)) return false;
+        acc.add_day(d, k, p, f);
+        expected = add_days(expected, 1);
+    }
+    if (!(expected == add_days(last, 1)) && !(last < from)) return false;
+    in.close();
+
+    for (const auto& b : new_batches) {
+        auto prod = db.find_id(b.product_id);
+        if (prod) acc.add_batch(b.start, b.days, db.view(*prod), b.qty);
+    }
+    for (const auto& e : new_extras) acc.add_day(e.date, e.kcal, e.prot, e.fiber);
+    const auto per = acc.finish();
+
+    std::string tail;
+    tail.reserve(per.size() * 40);
+    for (size_t i = 0; i < per.size(); ++i) {
+        append_history_row(tail, per.date_at(i), per.kcal[i], per.prot[i], per.fiber[i]);
+    }
+
+    {
+        std::fstream out(out_csv, std::ios::in | std::ios::out | std::ios::binary);
+        if (!out) return false;
+        out.seekp(offset);
+        out.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::resize_file(out_csv, static_cast<std::uintmax_t>(offset) + tail.size(), ec);
+    return !ec;
+}
+
+int update_food_history_csv(const ProductDB& db,
+                            const std::vector<Batch>& new_batches,
+                            const std::vector<Extra>& new_extras,
+                            const std::string& batches,
+                            const std::string& extras,
+                            const std::string& out_csv,
+                            std::ostream& err) {
+    {
+        PROFILE_ZONE("history/patch");
+        if (patch_food_history_csv(db, new_batches, new_extras, out_csv)) return 0;
+    }
+    return rebuild_food_history_csv(db, batches, extras, out_csv, err);
+}
+
+// food_history.csv: date,kcal,protein,fiber
+struct HistoryColumns {
+    std::vector<int32_t> dates;
+    std::vector<double> kcal, prot, fiber;
+
+    void append(const HistoryColumns& o) {
+        dates.insert(dates.end(), o.dates.begin(), o.dates.end());
+        kcal.insert(kcal.end(), o.kcal.begin(), o.kcal.end());
+        prot.insert(prot.end(), o.prot.begin(), o.prot.end());
+        fiber.insert(fiber.end(), o.fiber.begin(), o.fiber.end());
+    }
+};
+
+static void parse_history_rows(std::string_view text, HistoryColumns& out) {
+    auto reader = CsvReader::from_text(text);
+    std::span<const std::string_view> c;
+    while (reader.next(c)) {
+        Date d{};
+        double k = 0.0, p = 0.0, f = 0.0;
+        if (!parse_history_row(c, d, k, p, f)) continue;
+        out.dates.push_back(d.serial);
+        out.kcal.push_back(k);
+        out.prot.push_back(p);
+        out.fiber.push_back(f);
+    }
+}
+
+static std::vector<double> prefix_sums(const std::vector<double>& v) {
+    std::vector<double> out(v.size());
+    double acc = 0.0;
+    for (size_t i = 0; i < v.size(); ++i) out[i] = acc += v[i];
+    return out;
+}
+
+static std::vector<uint64_t> history_image(const HistoryColumns& cols, const SourceStamp& src) {
+    SnapshotBuilder b(SnapshotKind::History, cols.dates.size());
+    b.add_i32(cols.dates);               // H_DATE
+    b.add_f64(cols.kcal);                // H_KCAL
+    b.add_f64(cols.prot);                // H_PROT
+    b.add_f64(cols.fiber);               // H_FIBER
+    b.add_f64(prefix_sums(cols.kcal));   // H_KCAL_SUM
+    b.add_f64(prefix_sums(cols.prot));   // H_PROT_SUM
+    b.add_f64(prefix_sums(cols.fiber));  // H_FIBER_SUM
+    return b.finish(src);
+}
+
+static std::vector<uint64_t> import_history(const std::string& csv, const SourceStamp& src) {
+    MappedFile file(csv);
+    auto reader = CsvReader::from_text(file.data());
+    std::span<const std::string_view> header;
+    reader.next(header);
+
+    const auto ranges = parse_ranges(reader.remaining());
+    auto parts = parse_parallel<HistoryColumns>(ranges, parse_history_rows);
+    HistoryColumns cols = std::move(parts.front());
+    for (size_t i = 1; i < parts.size(); ++i) cols.append(parts[i]);
+
+    return history_image(cols, src);
+}
+
+Snapshot load_history_snapshot(const std::string& history_csv) {
+    return load_or_import_snapshot(history_csv, SnapshotKind::History, import_history);
+}
+
+Snapshot load_history_range(const std::string& history_csv, const DateRange& range) {
+    PROFILE_ZONE("history/load range");
+    const SourceStamp src = stamp_of(history_csv);
+    // snapshot persisté à jour : déjà projeté, print_grouped_history y cherche la plage
+    Snapshot snap = Snapshot::open(snapshot_path_for(history_csv), SnapshotKind::History, src);
+    if (snap.valid()) return snap;
+
+    MappedFile file(history_csv, MappedFile::Access::Random);
+    const std::string_view text = file.data();
+    const size_t header = text.find('\n');
+    HistoryColumns cols;
+    if (header != std::string_view::npos) {
+        const auto start = seek_date_sorted(text, header + 1, range.from);
+        if (!start) return load_history_snapshot(history_csv);
+
+        // le fichier est dense et trié : on s'arrête au premier jour après la plage
+        auto reader = CsvReader::from_text(text.substr(*start));
+        std::span<const std::string_view> c;
+        while (reader.next(c)) {
+            Date d{};
+            double k = 0.0, p = 0.0, f = 0.0;
+            if (!parse_history_row(c, d, k, p, f)) continue;
+            if (range.to < d) break;
+            cols.dates.push_back(d.serial);
+            cols.kcal.push_back(k);
+            cols.prot.push_back(p);
+            cols.fiber.push_back(f);
+        }
+    }
+
+    return Snapshot::from_image(history_image(cols, src), SnapshotKind::History);
+}
+
+int print_grouped_history(const Snapshot& snap, std::ostream& out, const DateRange& range) {
+    PROFILE_ZONE("history/print");
+    using namespace snapcol;
+    const auto all_dates = snap.i32(H_DATE);
+    // colonne de dates triée : la plage est un intervalle de lignes
+    const size_t lo = std::lower_bound(all_dates.begin(), all_dates.end(), range.from.serial) - all_dates.begin();
+    const size_t hi = std::max(lo, static_cast<size_t>(std::upper_bound(all_dates.begin(), all_dates.end(), range.to.serial) - all_dates.begin()));
+    const auto dates = all_dates.subspan(lo, hi - lo);
+    const auto kcals = snap.f64(H_KCAL).subspan(lo, hi - lo);
+    const auto prots = snap.f64(H_PROT).subspan(lo, hi - lo);
+    const auto fibers = snap.f64(H_FIBER).subspan(lo, hi - lo);
+
+    bool started = false;
+    Date grp_start{}, grp_end{};
+    double grp_kcal = 0.0, grp_prot = 0.0, grp_fiber = 0.0;
+
+    auto flush_group = [&]() {
+        if (!started) return;
+        if (same_val(grp_kcal, 0.0) && same_val(grp_prot, 0.0) && same_val(grp_fiber, 0.0)) return;
+
+        if (grp_start == grp_end) {
+            out << format_date(grp_start) << " : " << round2(grp_kcal)
+                      << " kcal | " << round2(grp_prot) << " g prot | " << round2(grp_fiber) << " g fiber\n";
+        } else {
+            out << format_date(grp_start) << " -> " << format_date(grp_end) << " : " << round2(grp_kcal)
+                      << " kcal | " << round2(grp_prot) << " g prot | " << round2(grp_fiber) << " g fiber\n";
+        }
+    };
+
+    bool have_prev = false;
+    Date prev{};
+
+    for (size_t i = 0; i < dates.size(); ++i) {
+        const Date cur{dates[i]};
+        const double kcal = kcals[i], prot = prots[i], fiber = fibers[i];
+
+        bool consecutive = false;
+        if (have_prev) {
+            Date expected = add_days(prev, 1);
+            consecutive = (cur == expected);
+        }
+
+        if (!started) {
+            started = true;
+            grp_start = grp_end = cur;
+            grp_kcal = kcal; grp_prot = prot; grp_fiber = fiber;
+        } else {
+            if (consecutive && same_val(kcal, grp_kcal) && same_val(prot, grp_prot) && same_val(fiber, grp_fiber)) {
+                grp_end = cur;
+            } else {
+                flush_group();
+                grp_start = grp_end = cur;
+                grp_kcal = kcal; grp_prot = prot; grp_fiber = fiber;
+            }
+        }
+
+        prev = cur;
+        have_prev = true;
+    }
+
+    if (!started) {
+        out << (range.bounded() ? "Aucun jour sur la période.\n" : "Historique vide.\n");
+        return 0;
+    }
+
+    flush_group();
+    return 0;
+}
+
+NutrientTotals history_totals(const Snapshot& snap, const DateRange& range) {
+    using namespace snapcol;
+    const auto dates = snap.i32(H_DATE);
+    const size_t lo = std::lower_bound(dates.begin(), dates.end(), range.from.serial) - dates.begin();
+    const size_t hi = std::upper_bound(dates.begin(), dates.end(), range.to.serial) - dates.begin();
+    if (hi <= lo) return {};
+
+    // somme de [lo, hi) = P[hi - 1] - P[lo - 1]
+    const auto span_sum = [&](size_t col) {
+        const auto p = snap.f64(col);
+        return p[hi - 1] - (lo ? p[lo - 1] : 0.0);
+    };
+    return {static_cast<int>(hi - lo), span_sum(H_KCAL_SUM), span_sum(H_PROT_SUM), span_sum(H_FIBER_SUM)};
+}
+
+static Date period_end(const Date& start, StatsPeriod by, const Date& last) {
+    Date end = last;
+    if (by == StatsPeriod::Week) {
+        end = add_days(week_start(start), 6);
+    } else if (by == StatsPeriod::Month) {
+        const Ymd c = to_ymd(start);
+        end = add_days(c.m == 12 ? make_date(c.y + 1, 1, 1) : make_date(c.y, c.m + 1, 1), -1);
+    }
+    return end < last ? end : last;
+}
+
+int print_history_stats(const Snapshot& snap, std::ostream& out, const DateRange& range, StatsPeriod by) {
+    PROFILE_ZONE("history/stats");
+    const auto dates = snap.i32(snapcol::H_DATE);
+    if (dates.empty()) {
+        out << "Historique vide.\n";
+        return 0;
+    }
+    // plage ramenée aux jours présents (une plage ouverte = tout l'historique)
+    const Date first = std::max(range.from, Date{dates.front()});
+    const Date last = std::min(range.to, Date{dates.back()});
+    if (last < first) {
+        out << "Aucun jour sur la période.\n";
+        return 0;
+    }
+
+    char line[256];
+    for (Date start = first; !(last < start);) {
+        const Date end = period_end(start, by, last);
+        const NutrientTotals t = history_totals(snap, {start, end});
+        if (t.days > 0) {
+            const double n = t.days;
+            std::snprintf(line, sizeof(line),
+                          "%s -> %s (%d j) : %.2f kcal | %.2f g prot | %.2f g fiber"
+                          "  [moy. %.2f kcal | %.2f g prot | %.2f g fiber / j]\n",
+                          format_date(start).c_str(), format_date(end).c_str(), t.days,
+                          round2(t.kcal), round2(t.prot), round2(t.fiber),
+                          round2(t.kcal / n), round2(t.prot / n), round2(t.fiber / n));
+            out << line;
+        }
+        start = add_days(end, 1);
+    }
+    return 0;
+}
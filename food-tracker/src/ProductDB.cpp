@@ -1,7 +1,14 @@
 #include "ProductDB.hpp"
 #include "Csv.hpp"
+#include "Profile.hpp"
+#include "Record.hpp"
+#include "Snapshot.hpp"
+#include "TextFold.hpp"
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
+#include <tuple>
+#include <unordered_map>
 
 static std::string lower(std::string s) {
   std::transform(s.begin(), s.end(), s.begin(),
@@ -9,126 +16,501 @@ static std::string lower(std::string s) {
   return s;
 }
 
-static Unit parse_unit(const std::string& s) {
-  auto t = lower(trim(s));
-  if (t == "g") return Unit::G;
-  if (t == "ml" || t == "mL") return Unit::ML;
-  // défaut
-  return Unit::G;
+static char lower_ascii(char c) {
+  return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
 }
 
-static bool contains_ci(const std::string& hay, const std::string& needle) {
-  return lower(hay).find(lower(needle)) != std::string::npos;
+static bool equals_ci(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (lower_ascii(a[i]) != lower_ascii(b[i])) return false;
+  }
+  return true;
 }
 
-bool ProductDB::load(const std::string& path) {
-  products.clear(); by_id.clear(); by_token.clear();
-  auto lines = read_lines(path);
-  if (lines.empty()) return false;
-
-  // skip header
-  for (size_t i = 1; i < lines.size(); ++i) {
-    auto cols = split_csv_simple(lines[i]);
-    if (cols.size() < 6) continue;
-
-    Product p;
-    p.id = cols[0];
-    p.name = cols[1];
-    p.unit = parse_unit(cols[2]);
-    p.kcal_per_100 = std::stod(cols[3]);
-    p.prot_per_100 = std::stod(cols[4]);
-    p.fiber_per_100 = std::stod(cols[5]);
-    if (cols.size() >= 7) p.aliases_raw = cols[6];
-
-    size_t idx = products.size();
-    products.push_back(p);
-    by_id[lower(p.id)] = idx;
-
-    // tokens: id + name + aliases (séparés par |)
-    by_token[lower(p.id)] = idx;
-    by_token[lower(p.name)] = idx;
-    if (!p.aliases_raw.empty()) {
-      std::string a = p.aliases_raw;
-      size_t start = 0;
-      while (true) {
-        size_t pos = a.find('|', start);
-        std::string tok = (pos == std::string::npos) ? a.substr(start) : a.substr(start, pos-start);
-        tok = lower(trim(tok));
-        if (!tok.empty()) by_token[tok] = idx;
-        if (pos == std::string::npos) break;
-        start = pos + 1;
-      }
+// FNV-1a sur les octets passés en minuscules (clé insensible à la casse)
+static uint64_t hash_ci(std::string_view s) {
+  uint64_t h = 1469598103934665603ULL;
+  for (char c : s) {
+    h ^= static_cast<unsigned char>(lower_ascii(c));
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// Table à adressage ouvert (sondage linéaire, charge <= 1/2) :
+// slot = index + 1, 0 = vide.
+static std::vector<uint32_t> build_slots(size_t n, auto key_of) {
+  size_t cap = 8;
+  while (cap < 2 * n) cap <<= 1;
+  std::vector<uint32_t> slots(cap, 0);
+  for (size_t i = 0; i < n; ++i) {
+    size_t s = hash_ci(key_of(i)) & (cap - 1);
+    while (slots[s] != 0) s = (s + 1) & (cap - 1);
+    slots[s] = static_cast<uint32_t>(i + 1);
+  }
+  return slots;
+}
+
+static std::optional<size_t> probe_slots(std::span<const uint32_t> slots, std::string_view key, auto key_of) {
+  if (slots.empty()) return std::nullopt;
+  const size_t mask = slots.size() - 1;
+  for (size_t s = hash_ci(key) & mask, n = 0; n < slots.size(); s = (s + 1) & mask, ++n) {
+    if (slots[s] == 0) return std::nullopt;
+    const size_t i = slots[s] - 1;
+    if (equals_ci(key_of(i), key)) return i;
+  }
+  return std::nullopt;
+}
+
+static std::string lower_view(std::string_view s) {
+  std::string out(s);
+  for (auto& c : out) c = lower_ascii(c);
+  return out;
+}
+
+// Texte de recherche d'un produit : id, nom et alias en minuscules, séparés
+// par un caractère qu'une requête ne contient jamais.
+static constexpr char SEARCH_SEP = '\x1f';
+
+static uint32_t gram_at(std::string_view s, size_t i) {
+  return (uint32_t(uint8_t(s[i])) << 16) | (uint32_t(uint8_t(s[i + 1])) << 8) | uint8_t(s[i + 2]);
+}
+
+// Tri stable par trigramme (octets 4 à 6), en trois passes de comptage :
+// les paires sont produites par produit croissant, qui reste donc l'ordre
+// à l'intérieur d'une liste. Bien plus rapide qu'un std::sort sur des
+// dizaines de millions de paires.
+static void sort_by_gram(std::vector<uint64_t>& pairs) {
+  std::vector<uint64_t> tmp(pairs.size());
+  for (int shift = 32; shift < 56; shift += 8) {
+    size_t count[257] = {};
+    for (uint64_t p : pairs) ++count[((p >> shift) & 0xFF) + 1];
+    for (size_t b = 1; b < 257; ++b) count[b] += count[b - 1];
+    for (uint64_t p : pairs) tmp[count[(p >> shift) & 0xFF]++] = p;
+    pairs.swap(tmp);
+  }
+}
+
+struct ProductColumns {
+  StrColumn ids, names, aliases;
+  std::vector<uint8_t> units;
+  std::vector<double> kcal, prot, fiber;
+  record::RowIssues issues;
+
+  void append(const ProductColumns& o) {
+    ids.append(o.ids);
+    names.append(o.names);
+    aliases.append(o.aliases);
+    units.insert(units.end(), o.units.begin(), o.units.end());
+    kcal.insert(kcal.end(), o.kcal.begin(), o.kcal.end());
+    prot.insert(prot.end(), o.prot.begin(), o.prot.end());
+    fiber.insert(fiber.end(), o.fiber.begin(), o.fiber.end());
+    issues.merge(o.issues);
+  }
+};
+
+static void parse_product_rows(std::string_view text, ProductColumns& out) {
+  auto reader = CsvReader::from_text(text);
+  std::span<const std::string_view> cols;
+  ProductView p;
+  record::RowError err;
+  while (reader.next(cols)) {
+    if (!record::decode(reader, cols, p, err)) {
+      out.issues.note(reader.record(), err);
+      continue;
+    }
+    out.ids.push(p.id);
+    out.names.push(p.name);
+    out.units.push_back(static_cast<uint8_t>(p.unit));
+    out.kcal.push_back(p.kcal_per_100);
+    out.prot.push_back(p.prot_per_100);
+    out.fiber.push_back(p.fiber_per_100);
+    out.aliases.push(p.aliases_raw);
+  }
+}
+
+// food_products.csv: id,name,unit,kcal_per_100,prot_per_100,fiber_per_100,aliases
+static std::vector<uint64_t> import_products(const std::string& csv, const SourceStamp& src) {
+  MappedFile file(csv);
+  auto reader = CsvReader::from_text(file.data());
+  std::span<const std::string_view> header;
+  const bool header_ok = !reader.next(header) || record::check_header<ProductView>(header);
+
+  const auto ranges = parse_ranges(reader.remaining());
+  auto parts = parse_parallel<ProductColumns>(ranges, parse_product_rows);
+  ProductColumns rows = std::move(parts.front());
+  for (size_t i = 1; i < parts.size(); ++i) rows.append(parts[i]);
+  record::report<ProductView>(std::cerr, csv, file.data(), header_ok, rows.issues);
+  parts.clear();
+  const StrColumn& ids = rows.ids;
+  const StrColumn& names = rows.names;
+  const StrColumn& aliases = rows.aliases;
+  const auto& units = rows.units;
+  const auto& kcal = rows.kcal;
+  const auto& prot = rows.prot;
+  const auto& fiber = rows.fiber;
+  const size_t n = units.size();
+
+  // id -> produit : en cas de doublon, la dernière ligne gagne
+  std::unordered_map<std::string, uint32_t> last_id;
+  last_id.reserve(n);
+  for (size_t i = 0; i < n; ++i) last_id[lower(std::string(ids.at(i)))] = static_cast<uint32_t>(i);
+  std::vector<uint32_t> id_rows;
+  for (size_t i = 0; i < n; ++i) {
+    if (last_id[lower(std::string(ids.at(i)))] == i) id_rows.push_back(static_cast<uint32_t>(i));
+  }
+  auto id_slots = build_slots(id_rows.size(), [&](size_t k) { return ids.at(id_rows[k]); });
+  for (auto& s : id_slots) if (s) s = id_rows[s - 1] + 1;
+
+  // jetons : id + name + aliases (séparés par |), en minuscules
+  StrColumn tokens;
+  std::vector<uint32_t> token_product;
+  std::unordered_map<std::string, uint32_t> token_index;
+  token_index.reserve(2 * n);
+  auto add_token = [&](std::string tok, size_t idx) {
+    if (tok.empty()) return;
+    auto [it, inserted] = token_index.try_emplace(tok, static_cast<uint32_t>(token_product.size()));
+    if (inserted) {
+      tokens.push(tok);
+      token_product.push_back(static_cast<uint32_t>(idx));
+    } else {
+      token_product[it->second] = static_cast<uint32_t>(idx);
+    }
+  };
+  for (size_t idx = 0; idx < n; ++idx) {
+    add_token(lower(std::string(ids.at(idx))), idx);
+    add_token(lower(std::string(names.at(idx))), idx);
+    std::string_view a = aliases.at(idx);
+    size_t start = 0;
+    while (!a.empty()) {
+      size_t pos = a.find('|', start);
+      auto tok = (pos == std::string_view::npos) ? a.substr(start) : a.substr(start, pos - start);
+      add_token(lower(std::string(trim_view(tok))), idx);
+      if (pos == std::string_view::npos) break;
+      start = pos + 1;
+    }
+  }
+  auto token_slots = build_slots(tokens.size(), [&](size_t k) { return tokens.at(k); });
+
+  // index inversé trigramme -> produits (listes triées, sans doublon)
+  StrColumn search_text;
+  std::vector<uint64_t> pairs; // (trigramme << 32) | produit
+  for (size_t idx = 0; idx < n; ++idx) {
+    std::string t = lower_view(ids.at(idx));
+    t += SEARCH_SEP;
+    t += lower_view(names.at(idx));
+    t += SEARCH_SEP;
+    t += lower_view(aliases.at(idx));
+    for (size_t i = 0; i + 3 <= t.size(); ++i) {
+      if (t[i] == SEARCH_SEP || t[i + 1] == SEARCH_SEP || t[i + 2] == SEARCH_SEP) continue;
+      pairs.push_back((uint64_t(gram_at(t, i)) << 32) | idx);
+    }
+    search_text.push(t);
+  }
+  sort_by_gram(pairs);
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  std::vector<uint32_t> gram_keys, gram_offsets, gram_postings;
+  gram_postings.reserve(pairs.size());
+  for (uint64_t pr : pairs) {
+    const auto g = uint32_t(pr >> 32);
+    if (gram_keys.empty() || gram_keys.back() != g) {
+      gram_keys.push_back(g);
+      gram_offsets.push_back(static_cast<uint32_t>(gram_postings.size()));
+    }
+    gram_postings.push_back(uint32_t(pr));
+  }
+  gram_offsets.push_back(static_cast<uint32_t>(gram_postings.size()));
+
+  // termes approchés (repliés) + BK-tree : noeud i = terme i, racine = 0.
+  // Un terme (mot du nom surtout) peut être partagé : ses produits sont
+  // fuzzy_product[fuzzy_offsets[i], fuzzy_offsets[i + 1]), triés.
+  StrColumn fuzzy_terms;
+  std::vector<uint64_t> term_pairs; // (terme << 32) | produit
+  std::unordered_map<std::string, uint32_t> term_index;
+  term_index.reserve(3 * n);
+  auto add_term = [&](std::string_view raw, size_t idx) {
+    std::string t = fold_text(trim_view(raw));
+    if (t.empty()) return;
+    auto [it, inserted] = term_index.try_emplace(t, static_cast<uint32_t>(fuzzy_terms.size()));
+    if (inserted) fuzzy_terms.push(t);
+    term_pairs.push_back((uint64_t(it->second) << 32) | idx);
+  };
+  for (size_t idx = 0; idx < n; ++idx) {
+    add_term(ids.at(idx), idx);
+    const std::string_view name = names.at(idx);
+    add_term(name, idx);
+    size_t w = 0;
+    while (w < name.size()) {
+      size_t e = name.find_first_of(" -'/,", w);
+      if (e == std::string_view::npos) e = name.size();
+      if (e - w >= 3) add_term(name.substr(w, e - w), idx);
+      w = e + 1;
+    }
+    std::string_view a = aliases.at(idx);
+    size_t start = 0;
+    while (!a.empty()) {
+      size_t pos = a.find('|', start);
+      add_term(pos == std::string_view::npos ? a.substr(start) : a.substr(start, pos - start), idx);
+      if (pos == std::string_view::npos) break;
+      start = pos + 1;
     }
   }
-  return !products.empty();
+  std::sort(term_pairs.begin(), term_pairs.end());
+  term_pairs.erase(std::unique(term_pairs.begin(), term_pairs.end()), term_pairs.end());
+  const size_t nt = fuzzy_terms.size();
+  std::vector<uint32_t> fuzzy_offsets(nt + 1, 0), fuzzy_product;
+  fuzzy_product.reserve(term_pairs.size());
+  for (uint64_t pr : term_pairs) {
+    ++fuzzy_offsets[(pr >> 32) + 1];
+    fuzzy_product.push_back(uint32_t(pr));
+  }
+  for (size_t t = 0; t < nt; ++t) fuzzy_offsets[t + 1] += fuzzy_offsets[t];
+
+  std::vector<uint32_t> bk_child(nt, 0), bk_sibling(nt, 0), bk_edge(nt, 0);
+  for (size_t t = 1; t < nt; ++t) {
+    size_t node = 0;
+    while (true) {
+      const auto d = static_cast<uint32_t>(edit_distance(fuzzy_terms.at(t), fuzzy_terms.at(node), INT32_MAX - 1));
+      uint32_t c = bk_child[node];
+      while (c != 0 && bk_edge[c - 1] != d) c = bk_sibling[c - 1];
+      if (c != 0) { node = c - 1; continue; }
+      bk_edge[t] = d;
+      bk_sibling[t] = bk_child[node];
+      bk_child[node] = static_cast<uint32_t>(t + 1);
+      break;
+    }
+  }
+
+  SnapshotBuilder b(SnapshotKind::Products, n);
+  b.add_str(ids);             // P_ID
+  b.add_str(names);           // P_NAME
+  b.add_u8(units);            // P_UNIT
+  b.add_f64(kcal);            // P_KCAL
+  b.add_f64(prot);            // P_PROT
+  b.add_f64(fiber);           // P_FIBER
+  b.add_str(aliases);         // P_ALIASES
+  b.add_u32(id_slots);        // P_ID_SLOTS
+  b.add_str(tokens);          // P_TOKENS
+  b.add_u32(token_product);   // P_TOKEN_PRODUCT
+  b.add_u32(token_slots);     // P_TOKEN_SLOTS
+  b.add_str(search_text);     // P_SEARCH_TEXT
+  b.add_u32(gram_keys);       // P_GRAM_KEYS
+  b.add_u32(gram_offsets);    // P_GRAM_OFFSETS
+  b.add_u32(gram_postings);   // P_GRAM_POSTINGS
+  b.add_str(fuzzy_terms);     // P_FUZZY_TERMS
+  b.add_u32(fuzzy_product);   // P_FUZZY_PRODUCT
+  b.add_u32(fuzzy_offsets);   // P_FUZZY_OFFSETS
+  b.add_u32(bk_child);        // P_BK_CHILD
+  b.add_u32(bk_sibling);      // P_BK_SIBLING
+  b.add_u32(bk_edge);         // P_BK_EDGE
+  return b.finish(src);
+}
+
+bool ProductDB::load(const std::string& path) {
+  PROFILE_ZONE("ProductDB::load");
+  snap = Snapshot{};
+  if (!file_exists(path)) return false;
+  snap = load_or_import_snapshot(path, SnapshotKind::Products, import_products);
+  return size() > 0;
+}
+
+ProductView ProductDB::view(size_t i) const {
+  using namespace snapcol;
+  ProductView v;
+  v.id = snap.str(P_ID, i);
+  v.name = snap.str(P_NAME, i);
+  v.unit = static_cast<Unit>(snap.u8(P_UNIT)[i]);
+  v.kcal_per_100 = snap.f64(P_KCAL)[i];
+  v.prot_per_100 = snap.f64(P_PROT)[i];
+  v.fiber_per_100 = snap.f64(P_FIBER)[i];
+  v.aliases_raw = snap.str(P_ALIASES, i);
+  return v;
+}
+
+std::optional<size_t> ProductDB::find_id(std::string_view id) const {
+  using namespace snapcol;
+  return probe_slots(snap.u32(P_ID_SLOTS), id,
+                     [&](size_t i) { return snap.str(P_ID, i); });
+}
+
+std::optional<size_t> ProductDB::find_token(std::string_view token) const {
+  using namespace snapcol;
+  auto t = probe_slots(snap.u32(P_TOKEN_SLOTS), token,
+                       [&](size_t i) { return snap.str(P_TOKENS, i); });
+  if (!t) return std::nullopt;
+  return snap.u32(P_TOKEN_PRODUCT)[*t];
 }
 
 std::optional<Product> ProductDB::get_by_id(const std::string& id) const {
-  auto it = by_id.find(lower(id));
-  if (it == by_id.end()) return std::nullopt;
-  return products[it->second];
+  auto i = find_id(id);
+  if (!i) return std::nullopt;
+  return view(*i).to_product();
+}
+
+// Intersection de deux listes triées (la plus courte guide, recherche
+// dichotomique dans l'autre).
+static std::vector<uint32_t> intersect(const std::vector<uint32_t>& small, std::span<const uint32_t> big) {
+  std::vector<uint32_t> out;
+  auto it = big.begin();
+  for (uint32_t v : small) {
+    it = std::lower_bound(it, big.end(), v);
+    if (it == big.end()) break;
+    if (*it == v) out.push_back(v);
+  }
+  return out;
 }
 
-std::vector<Product> ProductDB::search(const std::string& query) const {
-  std::vector<Product> out;
-  for (const auto& p : products) {
-    if (contains_ci(p.id, query) || contains_ci(p.name, query) || contains_ci(p.aliases_raw, query))
-      out.push_back(p);
+std::vector<size_t> ProductDB::search(std::string_view query, size_t limit) const {
+  using namespace snapcol;
+  std::vector<size_t> out;
+  const auto needle = lower_view(query);
+  if (needle.empty() || needle.find(SEARCH_SEP) != std::string::npos) return out;
+
+  auto matches = [&](size_t i) {
+    return snap.str(P_SEARCH_TEXT, i).find(needle) != std::string_view::npos;
+  };
+
+  if (needle.size() < 3) {
+    // trop court pour l'index : balayage du texte déjà en minuscules
+    for (size_t i = 0; i < size() && out.size() < limit; ++i) if (matches(i)) out.push_back(i);
+    return out;
+  }
+
+  const auto keys = snap.u32(P_GRAM_KEYS);
+  const auto offsets = snap.u32(P_GRAM_OFFSETS);
+  const auto postings = snap.u32(P_GRAM_POSTINGS);
+
+  std::vector<std::span<const uint32_t>> lists;
+  for (size_t i = 0; i + 3 <= needle.size(); ++i) {
+    const uint32_t g = gram_at(needle, i);
+    auto k = std::lower_bound(keys.begin(), keys.end(), g);
+    if (k == keys.end() || *k != g) return out; // trigramme absent : aucun résultat
+    const size_t ki = static_cast<size_t>(k - keys.begin());
+    lists.push_back(postings.subspan(offsets[ki], offsets[ki + 1] - offsets[ki]));
+  }
+  std::sort(lists.begin(), lists.end(),
+            [](const auto& a, const auto& b) { return a.size() < b.size(); });
+
+  std::vector<uint32_t> cand(lists[0].begin(), lists[0].end());
+  for (size_t l = 1; l < lists.size() && !cand.empty(); ++l) cand = intersect(cand, lists[l]);
+
+  // les trigrammes ne garantissent pas la contiguïté : vérification finale
+  for (size_t k = 0; k < cand.size() && out.size() < limit; ++k) {
+    if (matches(cand[k])) out.push_back(cand[k]);
   }
   return out;
 }
 
-std::optional<Product> ProductDB::resolve(const std::string& user_input) const {
-  auto key = lower(trim(user_input));
+std::optional<size_t> ProductDB::resolve(std::string_view user_input) const {
+  auto key = lower_view(trim_view(user_input));
   if (key.empty()) return std::nullopt;
 
   // match direct token
-  auto it = by_token.find(key);
-  if (it != by_token.end()) return products[it->second];
+  if (auto i = find_token(key)) return i;
 
   // fallback: recherche "contains" si unique
-  auto matches = search(key);
+  auto matches = search(key, 2);
   if (matches.size() == 1) return matches[0];
   return std::nullopt;
 }
 
-bool ProductDB::add_interactive(const std::string& path) {
+// Distance tolérée selon la longueur de la requête repliée.
+static int max_fuzzy_distance(size_t len) {
+  if (len <= 3) return 1;
+  if (len <= 7) return 2;
+  return 3;
+}
+
+std::vector<FuzzyMatch> ProductDB::fuzzy(std::string_view query, size_t k) const {
+  using namespace snapcol;
+  std::vector<FuzzyMatch> out;
+  const std::string q = fold_text(trim_view(query));
+  const auto child = snap.u32(P_BK_CHILD);
+  if (q.empty() || child.empty() || k == 0) return out;
+
+  const auto sibling = snap.u32(P_BK_SIBLING);
+  const auto edge = snap.u32(P_BK_EDGE);
+  const auto term_product = snap.u32(P_FUZZY_PRODUCT);
+  const auto term_offsets = snap.u32(P_FUZZY_OFFSETS);
+  const int bound = max_fuzzy_distance(q.size());
+
+  // Levenshtein (métrique) pour parcourir l'arbre ; le classement utilise
+  // la distance de frappe puis l'écart de longueur du meilleur terme.
+  struct Best { int distance; size_t len_diff; };
+  std::unordered_map<size_t, Best> best;
+  std::vector<uint32_t> stack{0};
+  while (!stack.empty()) {
+    const uint32_t node = stack.back();
+    stack.pop_back();
+    const std::string_view term = snap.str(P_FUZZY_TERMS, node);
+    const int d = edit_distance(q, term, INT32_MAX - 1);
+    if (d <= bound) {
+      const Best b{typo_distance(q, term), term.size() > q.size() ? term.size() - q.size() : q.size() - term.size()};
+      // tous les produits du terme sont classés, pas seulement le dernier
+      for (uint32_t i = term_offsets[node]; i < term_offsets[node + 1]; ++i) {
+        auto [it, inserted] = best.try_emplace(term_product[i], b);
+        if (!inserted && std::tie(b.distance, b.len_diff) < std::tie(it->second.distance, it->second.len_diff)) {
+          it->second = b;
+        }
+      }
+    }
+    // inégalité triangulaire : seuls les enfants à |edge - d| <= bound
+    for (uint32_t c = child[node]; c != 0; c = sibling[c - 1]) {
+      if (std::abs(static_cast<int>(edge[c - 1]) - d) <= bound) stack.push_back(c - 1);
+    }
+  }
+
+  std::vector<std::pair<Best, size_t>> ranked;
+  ranked.reserve(best.size());
+  for (const auto& [product, b] : best) ranked.push_back({b, product});
+  std::sort(ranked.begin(), ranked.end(), [](const auto& x, const auto& y) {
+    return std::tie(x.first.distance, x.first.len_diff, x.second) <
+           std::tie(y.first.distance, y.first.len_diff, y.second);
+  });
+  for (const auto& [b, product] : ranked) {
+    if (out.size() == k) break;
+    out.push_back(FuzzyMatch{product, b.distance});
+  }
+  return out;
+}
+
+bool ProductDB::add_interactive(const std::string& path, std::istream& in, std::ostream& out) const {
   Product p;
-  std::cout << "id (ex: bread): ";
-  std::getline(std::cin, p.id);
+  out << "id (ex: bread): ";
+  std::getline(in, p.id);
   p.id = trim(p.id);
 
-  std::cout << "name (ex: Pain de mie): ";
-  std::getline(std::cin, p.name);
+  out << "name (ex: Pain de mie): ";
+  std::getline(in, p.name);
   p.name = trim(p.name);
 
   std::string unit;
-  std::cout << "unit (g ou mL): ";
-  std::getline(std::cin, unit);
+  out << "unit (g ou mL): ";
+  std::getline(in, unit);
   p.unit = parse_unit(unit);
 
   std::string kcal;
-  std::cout << "kcal_per_100 (ex: 265): ";
-  std::getline(std::cin, kcal);
-  p.kcal_per_100 = std::stod(trim(kcal));
+  out << "kcal_per_100 (ex: 265): ";
+  std::getline(in, kcal);
+  if (!parse_double(trim_view(kcal), p.kcal_per_100)) return false;
 
   std::string prot;
-  std::cout << "prot_per_100 (ex: 10): ";
-  std::getline(std::cin, prot);
-  p.prot_per_100 = std::stod(trim(prot));
+  out << "prot_per_100 (ex: 10): ";
+  std::getline(in, prot);
+  if (!parse_double(trim_view(prot), p.prot_per_100)) return false;
 
   std::string fiber;
-  std::cout << "fiber_per_100 (ex: 2): ";
-  std::getline(std::cin, fiber);
-  p.fiber_per_100 = std::stod(trim(fiber));
+  out << "fiber_per_100 (ex: 2): ";
+  std::getline(in, fiber);
+  if (!parse_double(trim_view(fiber), p.fiber_per_100)) return false;
 
-  std::cout << "aliases (optionnel, séparés par |): ";
-  std::getline(std::cin, p.aliases_raw);
+  out << "aliases (optionnel, séparés par |): ";
+  std::getline(in, p.aliases_raw);
   p.aliases_raw = trim(p.aliases_raw);
 
   // append
-  append_line(path,
-    p.id + "," + p.name + "," + to_string(p.unit) + "," + std::to_string(p.kcal_per_100) + "," + std::to_string(p.prot_per_100) + "," + std::to_string(p.fiber_per_100) + "," + p.aliases_raw
-  );
+  append_line(path, record::encode(p));
   return true;
 }
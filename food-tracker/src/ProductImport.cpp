@@ -0,0 +1,328 @@
+#include "ProductImport.hpp"
+#include "Csv.hpp"
+#include "Snapshot.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <unordered_set>
+
+namespace {
+
+enum Field { F_ID, F_NAME, F_UNIT, F_KCAL, F_KJ, F_PROT, F_FIBER, F_ALIASES, F_COUNT };
+
+constexpr const char* FIELD_NAMES[F_COUNT] = {"id", "name", "unit", "kcal", "kj", "prot", "fiber", "aliases"};
+
+// En-têtes reconnus par champ, par ordre de préférence (notre catalogue,
+// puis les noms OpenFoodFacts).
+const std::vector<std::string_view> FIELD_HEADERS[F_COUNT] = {
+  {"id", "code", "barcode", "ean"},
+  {"name", "product_name", "product_name_fr", "product_name_en", "generic_name"},
+  {"unit"},
+  {"kcal_per_100", "energy-kcal_100g", "energy_kcal_100g"},
+  {"energy-kj_100g", "energy_100g"},
+  {"prot_per_100", "proteins_100g"},
+  {"fiber_per_100", "fiber_100g"},
+  {"aliases"},
+};
+
+constexpr double KJ_PER_KCAL = 4.184;
+
+bool equals_ci(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    const auto x = static_cast<unsigned char>(a[i]), y = static_cast<unsigned char>(b[i]);
+    if (std::tolower(x) != std::tolower(y)) return false;
+  }
+  return true;
+}
+
+// Séparateur le plus fréquent de l'en-tête parmi tabulation, ';' et ','.
+char detect_separator(std::string_view header) {
+  const char candidates[] = {'\t', ';', ','};
+  char best = ',';
+  long best_count = 0;
+  for (char c : candidates) {
+    const long n = std::count(header.begin(), header.end(), c);
+    if (n > best_count) { best = c; best_count = n; }
+  }
+  return best;
+}
+
+// TSV : pas de guillemets (les exports OpenFoodFacts en contiennent de
+// non appariés dans les noms), un champ = tout jusqu'à la tabulation.
+void split_tsv_fields(std::string_view line, std::vector<std::string_view>& out) {
+  out.clear();
+  size_t i = 0;
+  while (true) {
+    const size_t s = line.find('\t', i);
+    out.push_back(trim_view(line.substr(i, s == std::string_view::npos ? std::string_view::npos : s - i)));
+    if (s == std::string_view::npos) break;
+    i = s + 1;
+  }
+}
+
+// Lignes acceptées d'une tranche : id en minuscules (clé de dédoublonnage)
+// et ligne prête pour food_products.csv.
+struct ParsedPart {
+  StrColumn keys;
+  StrColumn lines;
+  size_t rows = 0;
+  size_t invalid = 0;
+};
+
+class RowMapper {
+public:
+  RowMapper(const int (&cols)[F_COUNT], char sep) : sep_(sep) { std::copy(cols, cols + F_COUNT, cols_); }
+
+  void parse(std::string_view text, ParsedPart& out) const {
+    std::string line;
+    if (sep_ == '\t') {
+      std::vector<std::string_view> fields;
+      size_t pos = 0;
+      while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view l = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (trim_view(l).empty()) continue;
+        split_tsv_fields(l, fields);
+        map_row(fields, out, line);
+      }
+      return;
+    }
+    auto reader = CsvReader::from_text(text, sep_);
+    std::span<const std::string_view> row;
+    while (reader.next(row)) map_row(row, out, line);
+  }
+
+private:
+  std::string_view field(std::span<const std::string_view> row, Field f) const {
+    const int c = cols_[f];
+    return (c >= 0 && static_cast<size_t>(c) < row.size()) ? row[c] : std::string_view{};
+  }
+
+  void map_row(std::span<const std::string_view> row, ParsedPart& out, std::string& line) const {
+    ++out.rows;
+    const std::string_view id = field(row, F_ID);
+    const std::string_view name = field(row, F_NAME);
+    double kcal = 0.0, prot = 0.0, fiber = 0.0;
+    bool energy = parse_double(field(row, F_KCAL), kcal);
+    if (!energy && parse_double(field(row, F_KJ), kcal)) {
+      kcal /= KJ_PER_KCAL;
+      energy = true;
+    }
+    if (id.empty() || name.empty() || !energy || kcal < 0.0) { ++out.invalid; return; }
+    // macros absentes = 0 (fréquent dans les bases publiques)
+    if (!parse_double(field(row, F_PROT), prot)) prot = 0.0;
+    if (!parse_double(field(row, F_FIBER), fiber)) fiber = 0.0;
+
+    line.clear();
+    line += csv_escape(id);
+    line += ',';
+    line += csv_escape(name);
+    line += ',';
+    line += to_string(parse_unit(field(row, F_UNIT)));
+    line += ',';
+    append_double(line, kcal);
+    line += ',';
+    append_double(line, prot);
+    line += ',';
+    append_double(line, fiber);
+    line += ',';
+    line += csv_escape(field(row, F_ALIASES));
+    line += '\n';
+    out.lines.push(line);
+
+    std::string key(id);
+    for (char& c : key) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    out.keys.push(key);
+  }
+
+  int cols_[F_COUNT];
+  char sep_;
+};
+
+bool map_columns(std::span<const std::string_view> header, const ProductImportOptions& opt,
+                 int (&cols)[F_COUNT], std::string& error) {
+  auto find_header = [&](std::string_view name) {
+    for (size_t i = 0; i < header.size(); ++i) {
+      if (equals_ci(header[i], name)) return static_cast<int>(i);
+    }
+    return -1;
+  };
+
+  for (int f = 0; f < F_COUNT; ++f) {
+    cols[f] = -1;
+    for (auto h : FIELD_HEADERS[f]) {
+      if ((cols[f] = find_header(h)) >= 0) break;
+    }
+  }
+  for (const auto& [field, column] : opt.columns) {
+    const auto* it = std::find_if(std::begin(FIELD_NAMES), std::end(FIELD_NAMES),
+                                  [&](const char* n) { return field == n; });
+    if (it == std::end(FIELD_NAMES)) { error = "champ inconnu: " + field; return false; }
+    const int c = find_header(column);
+    if (c < 0) { error = "colonne absente de la source: " + column; return false; }
+    cols[it - std::begin(FIELD_NAMES)] = c;
+  }
+
+  if (cols[F_ID] < 0) { error = "colonne id introuvable (utiliser --map id=<colonne>)"; return false; }
+  if (cols[F_NAME] < 0) { error = "colonne name introuvable (utiliser --map name=<colonne>)"; return false; }
+  if (cols[F_KCAL] < 0 && cols[F_KJ] < 0) { error = "colonne kcal introuvable (utiliser --map kcal=<colonne>)"; return false; }
+  return true;
+}
+
+// Le catalogue doit finir par '\n' avant d'y ajouter des lignes.
+bool ends_with_newline(const std::string& path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in || in.tellg() <= 0) return true;
+  in.seekg(-1, std::ios::end);
+  char last = '\0';
+  in.get(last);
+  return last == '\n';
+}
+
+// Copie du catalogue à côté de lui, complétée puis renommée par-dessus à la
+// fin de l'import : un import interrompu ou une écriture ratée laisse
+// food_products.csv tel quel.
+class StagedCatalog {
+public:
+  explicit StagedCatalog(const std::string& path) : path_(path), tmp_(temp_path_for(path)) {}
+  ~StagedCatalog() {
+    if (!committed_) {
+      out_.close();
+      std::error_code ec;
+      std::filesystem::remove(tmp_, ec);
+    }
+  }
+
+  bool open() {
+    std::error_code ec;
+    if (std::filesystem::exists(path_, ec)) {
+      std::filesystem::copy_file(path_, tmp_, std::filesystem::copy_options::overwrite_existing, ec);
+      if (ec) return false;
+    }
+    out_.open(tmp_, std::ios::app | std::ios::binary);
+    if (out_ && !ends_with_newline(tmp_)) out_ << '\n';
+    return static_cast<bool>(out_);
+  }
+
+  std::ofstream& out() { return out_; }
+
+  bool commit() {
+    out_.close();
+    if (!out_) return false;
+    std::error_code ec;
+    std::filesystem::rename(tmp_, path_, ec);
+    committed_ = !ec;
+    return committed_;
+  }
+
+private:
+  std::string path_, tmp_;
+  std::ofstream out_;
+  bool committed_ = false;
+};
+
+} // namespace
+
+bool import_products_file(const ProductDB& db, const std::string& catalog_csv,
+                          const std::string& source, const ProductImportOptions& opt,
+                          ProductImportReport& report, std::string& error) {
+  const auto t0 = std::chrono::steady_clock::now();
+  report = {};
+
+  std::ifstream in(source, std::ios::binary);
+  if (!in) { error = "source illisible: " + source; return false; }
+
+  StagedCatalog catalog(catalog_csv);
+  if (!catalog.open()) { error = "catalogue non inscriptible: " + catalog_csv; return false; }
+  std::ofstream& out = catalog.out();
+
+  const size_t threads = opt.threads ? opt.threads : parse_threads();
+  const size_t chunk = std::max<size_t>(opt.chunk_bytes, 4096);
+
+  std::unordered_set<std::string> seen; // ids ajoutés (minuscules)
+  std::optional<RowMapper> mapper;
+  std::string buf, merged;
+  bool eof = false;
+  bool skipping = false; // fin d'une ligne trop longue, jetée jusqu'au '\n'
+
+  while (!eof) {
+    const size_t have = buf.size();
+    buf.resize(have + chunk);
+    in.read(buf.data() + have, static_cast<std::streamsize>(chunk));
+    buf.resize(have + static_cast<size_t>(in.gcount()));
+    eof = !in;
+
+    std::string_view text = buf;
+    if (!mapper) {
+      // en-tête : première ligne, séparateur détecté dessus
+      const size_t nl = text.find('\n');
+      if (nl == std::string_view::npos && !eof) {
+        error = "en-tête plus long qu'un bloc: " + source;
+        return false;
+      }
+      std::string_view head = text.substr(0, nl);
+      if (head.starts_with("\xEF\xBB\xBF")) head.remove_prefix(3); // BOM UTF-8
+      if (!head.empty() && head.back() == '\r') head.remove_suffix(1);
+      const char sep = detect_separator(head);
+
+      std::vector<std::string_view> header;
+      std::string scratch;
+      if (sep == '\t') split_tsv_fields(head, header);
+      else split_csv_fields(head, header, scratch, sep);
+      int cols[F_COUNT];
+      if (!map_columns(header, opt, cols, error)) return false;
+      mapper.emplace(cols, sep);
+      text = nl == std::string_view::npos ? std::string_view{} : text.substr(nl + 1);
+      buf.erase(0, buf.size() - text.size());
+      text = buf;
+    }
+
+    if (skipping) {
+      const size_t nl = text.find('\n');
+      if (nl == std::string_view::npos) { buf.clear(); continue; }
+      buf.erase(0, nl + 1);
+      text = buf;
+      skipping = false;
+    }
+
+    const size_t end = eof ? text.size() : complete_records_prefix(text);
+    if (end == 0 && !eof) {
+      // ligne plus longue qu'un bloc : comptée invalide et sautée, le tampon
+      // ne grossit pas au-delà de deux blocs
+      ++report.rows;
+      ++report.invalid;
+      buf.clear();
+      skipping = true;
+      continue;
+    }
+
+    const auto ranges = split_record_ranges(text.substr(0, end), threads);
+    const auto parts = parse_parallel<ParsedPart>(
+        ranges, [&](std::string_view r, ParsedPart& part) { mapper->parse(r, part); });
+
+    // fusion dans l'ordre du fichier : la première occurrence d'un id gagne
+    merged.clear();
+    for (const auto& p : parts) {
+      report.rows += p.rows;
+      report.invalid += p.invalid;
+      for (size_t i = 0; i < p.keys.size(); ++i) {
+        const std::string_view key = p.keys.at(i);
+        if (db.find_id(key) || !seen.emplace(key).second) { ++report.duplicates; continue; }
+        merged += p.lines.at(i);
+        ++report.added;
+      }
+    }
+    out.write(merged.data(), static_cast<std::streamsize>(merged.size()));
+    buf.erase(0, end);
+  }
+
+  if (!out || !catalog.commit()) { error = "écriture du catalogue échouée: " + catalog_csv; return false; }
+  report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return true;
+}
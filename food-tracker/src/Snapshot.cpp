@@ -0,0 +1,281 @@
+#include "Snapshot.hpp"
+#include "Profile.hpp"
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char SNAP_MAGIC[8] = {'D', 'A', 'P', 'P', 'S', 'N', 'A', 'P'};
+constexpr uint32_t SNAP_VERSION = 6;
+
+// Les colonnes sont lues telles quelles : seul un hôte little-endian peut
+// réutiliser un snapshot écrit sur disque.
+constexpr bool SNAP_NATIVE = std::endian::native == std::endian::little;
+
+#ifdef DAILYAPP_SNAPSHOTS
+constexpr bool SNAP_PERSIST = SNAP_NATIVE;
+#else
+constexpr bool SNAP_PERSIST = false;
+#endif
+
+struct SnapHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t kind;
+  uint64_t rows;
+  uint64_t source_size;
+  int64_t source_mtime_ns;
+  uint32_t columns;
+  uint32_t reserved;
+};
+static_assert(sizeof(SnapHeader) == 48);
+
+struct SnapColumn {
+  uint32_t type;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t bytes;
+};
+static_assert(sizeof(SnapColumn) == 24);
+
+struct StrRef {
+  uint32_t offset;
+  uint32_t len;
+};
+
+size_t align8(size_t n) { return (n + 7) & ~size_t{7}; }
+
+} // namespace
+
+SourceStamp stamp_of(const std::string& path) {
+  struct stat st{};
+  if (::stat(path.c_str(), &st) != 0) return {};
+  SourceStamp s;
+  s.size = static_cast<uint64_t>(st.st_size);
+  s.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+  s.ok = true;
+  return s;
+}
+
+std::string snapshot_path_for(const std::string& csv_path) {
+  return std::filesystem::path(csv_path).replace_extension(".snap").string();
+}
+
+// --- SnapshotBuilder ---
+
+SnapshotBuilder::SnapshotBuilder(SnapshotKind kind, size_t rows) : kind_(kind), rows_(rows) {}
+
+void SnapshotBuilder::add_i32(std::span<const int32_t> col) {
+  auto b = std::as_bytes(col);
+  cols_.push_back({ColumnType::I32, {reinterpret_cast<const uint8_t*>(b.data()), reinterpret_cast<const uint8_t*>(b.data()) + b.size()}});
+}
+
+void SnapshotBuilder::add_u32(std::span<const uint32_t> col) {
+  auto b = std::as_bytes(col);
+  cols_.push_back({ColumnType::U32, {reinterpret_cast<const uint8_t*>(b.data()), reinterpret_cast<const uint8_t*>(b.data()) + b.size()}});
+}
+
+void SnapshotBuilder::add_f64(std::span<const double> col) {
+  auto b = std::as_bytes(col);
+  cols_.push_back({ColumnType::F64, {reinterpret_cast<const uint8_t*>(b.data()), reinterpret_cast<const uint8_t*>(b.data()) + b.size()}});
+}
+
+void SnapshotBuilder::add_u8(std::span<const uint8_t> col) {
+  cols_.push_back({ColumnType::U8, {col.begin(), col.end()}});
+}
+
+void SnapshotBuilder::add_str(std::span<const std::string_view> col) {
+  std::vector<StrRef> refs(col.size());
+  for (size_t i = 0; i < col.size(); ++i) {
+    // offsets sur 32 bits : au-delà de 4 Gio de texte, l'image est refusée
+    if (pool_.size() + col[i].size() > UINT32_MAX) { overflow_ = true; break; }
+    refs[i] = StrRef{static_cast<uint32_t>(pool_.size()), static_cast<uint32_t>(col[i].size())};
+    pool_ += col[i];
+  }
+  const auto* p = reinterpret_cast<const uint8_t*>(refs.data());
+  cols_.push_back({ColumnType::Str, {p, p + refs.size() * sizeof(StrRef)}});
+}
+
+void SnapshotBuilder::add_str(const StrColumn& col) {
+  std::vector<std::string_view> views(col.size());
+  for (size_t i = 0; i < col.size(); ++i) views[i] = col.at(i);
+  add_str(views);
+}
+
+std::vector<uint64_t> SnapshotBuilder::finish(const SourceStamp& src) {
+  if (overflow_) {
+    cols_.clear();
+    pool_.clear();
+    return {};
+  }
+  cols_.push_back({ColumnType::Pool, {pool_.begin(), pool_.end()}});
+
+  size_t total = align8(sizeof(SnapHeader) + cols_.size() * sizeof(SnapColumn));
+  for (const auto& c : cols_) total += align8(c.bytes.size());
+
+  std::vector<uint64_t> image(total / 8, 0);
+  auto* base = reinterpret_cast<uint8_t*>(image.data());
+
+  SnapHeader h{};
+  std::memcpy(h.magic, SNAP_MAGIC, sizeof(SNAP_MAGIC));
+  h.version = SNAP_VERSION;
+  h.kind = static_cast<uint32_t>(kind_);
+  h.rows = rows_;
+  h.source_size = src.size;
+  h.source_mtime_ns = src.mtime_ns;
+  h.columns = static_cast<uint32_t>(cols_.size());
+  std::memcpy(base, &h, sizeof(h));
+
+  size_t off = align8(sizeof(SnapHeader) + cols_.size() * sizeof(SnapColumn));
+  for (size_t i = 0; i < cols_.size(); ++i) {
+    const auto& c = cols_[i];
+    SnapColumn d{static_cast<uint32_t>(c.type), 0, off, c.bytes.size()};
+    std::memcpy(base + sizeof(SnapHeader) + i * sizeof(SnapColumn), &d, sizeof(d));
+    if (!c.bytes.empty()) std::memcpy(base + off, c.bytes.data(), c.bytes.size());
+    off += align8(c.bytes.size());
+  }
+  cols_.clear();
+  pool_.clear();
+  return image;
+}
+
+// --- Snapshot ---
+
+bool Snapshot::attach(const uint8_t* base, size_t size, SnapshotKind kind) {
+  if (!base || size < sizeof(SnapHeader)) return false;
+  SnapHeader h{};
+  std::memcpy(&h, base, sizeof(h));
+  if (std::memcmp(h.magic, SNAP_MAGIC, sizeof(SNAP_MAGIC)) != 0) return false;
+  if (h.version != SNAP_VERSION || h.kind != static_cast<uint32_t>(kind)) return false;
+  if (h.columns == 0 || sizeof(SnapHeader) + uint64_t{h.columns} * sizeof(SnapColumn) > size) return false;
+
+  for (uint32_t i = 0; i < h.columns; ++i) {
+    SnapColumn d{};
+    std::memcpy(&d, base + sizeof(SnapHeader) + i * sizeof(SnapColumn), sizeof(d));
+    if (d.offset % 8 != 0 || d.offset > size || d.bytes > size - d.offset) return false;
+  }
+
+  base_ = base;
+  size_ = size;
+  rows_ = static_cast<size_t>(h.rows);
+  ncols_ = h.columns;
+  valid_ = true;
+  return true;
+}
+
+Snapshot Snapshot::open(const std::string& snap_path, SnapshotKind kind, const SourceStamp& src) {
+  Snapshot s;
+  if (!SNAP_NATIVE || !src.ok) return s;
+  // le catalogue produits est consulté par sondage (tables de hachage)
+  s.file_ = MappedFile(snap_path, kind == SnapshotKind::Products ? MappedFile::Access::Random
+                                                                 : MappedFile::Access::Sequential);
+  const auto data = s.file_.data();
+  if (!s.attach(reinterpret_cast<const uint8_t*>(data.data()), data.size(), kind)) return Snapshot{};
+
+  SnapHeader h{};
+  std::memcpy(&h, s.base_, sizeof(h));
+  if (h.source_size != src.size || h.source_mtime_ns != src.mtime_ns) return Snapshot{};
+  return s;
+}
+
+Snapshot Snapshot::from_image(std::vector<uint64_t> image, SnapshotKind kind) {
+  Snapshot s;
+  s.image_ = std::move(image);
+  s.attach(reinterpret_cast<const uint8_t*>(s.image_.data()), s.image_.size() * 8, kind);
+  return s;
+}
+
+std::span<const uint8_t> Snapshot::column(size_t col, ColumnType type, size_t width) const {
+  if (!valid_ || col >= ncols_) return {};
+  SnapColumn d{};
+  std::memcpy(&d, base_ + sizeof(SnapHeader) + col * sizeof(SnapColumn), sizeof(d));
+  if (d.type != static_cast<uint32_t>(type)) return {};
+  if (width != 0 && d.bytes != uint64_t{rows_} * width) return {};
+  return {base_ + d.offset, static_cast<size_t>(d.bytes)};
+}
+
+std::span<const int32_t> Snapshot::i32(size_t col) const {
+  auto b = column(col, ColumnType::I32, sizeof(int32_t));
+  return {reinterpret_cast<const int32_t*>(b.data()), b.size() / sizeof(int32_t)};
+}
+
+size_t Snapshot::str_count(size_t col) const {
+  return column(col, ColumnType::Str, 0).size() / sizeof(StrRef);
+}
+
+std::span<const uint32_t> Snapshot::u32(size_t col) const {
+  auto b = column(col, ColumnType::U32, 0); // longueur libre (tables d'index)
+  return {reinterpret_cast<const uint32_t*>(b.data()), b.size() / sizeof(uint32_t)};
+}
+
+std::span<const double> Snapshot::f64(size_t col) const {
+  auto b = column(col, ColumnType::F64, sizeof(double));
+  return {reinterpret_cast<const double*>(b.data()), b.size() / sizeof(double)};
+}
+
+std::span<const uint8_t> Snapshot::u8(size_t col) const {
+  return column(col, ColumnType::U8, 1);
+}
+
+std::string_view Snapshot::str(size_t col, size_t row) const {
+  auto refs = column(col, ColumnType::Str, 0);
+  if (row >= refs.size() / sizeof(StrRef)) return {};
+  SnapColumn pool{};
+  std::memcpy(&pool, base_ + sizeof(SnapHeader) + (ncols_ - 1) * sizeof(SnapColumn), sizeof(pool));
+  StrRef r{};
+  std::memcpy(&r, refs.data() + row * sizeof(StrRef), sizeof(r));
+  if (uint64_t{r.offset} + r.len > pool.bytes) return {};
+  return {reinterpret_cast<const char*>(base_ + pool.offset + r.offset), r.len};
+}
+
+bool write_snapshot(const std::string& snap_path, std::span<const uint64_t> image) {
+  const std::string tmp = temp_path_for(snap_path);
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size_bytes()));
+    if (!out) {
+      out.close();
+      std::filesystem::remove(tmp);
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp, snap_path, ec);
+  if (ec) std::filesystem::remove(tmp, ec);
+  return !ec;
+}
+
+Snapshot load_or_import_snapshot(const std::string& csv, SnapshotKind kind, SnapshotImporter import) {
+  const auto src = stamp_of(csv);
+  const auto snap_path = snapshot_path_for(csv);
+  if (SNAP_PERSIST) {
+    PROFILE_ZONE("snapshot/open");
+    auto s = Snapshot::open(snap_path, kind, src);
+    if (s.valid()) return s;
+  }
+
+  std::vector<uint64_t> image;
+  {
+    PROFILE_ZONE("snapshot/import csv");
+    image = import(csv, src);
+  }
+  if (image.empty()) {
+    // rien n'est écrit : le CSV reste la seule source au prochain chargement
+    std::cerr << csv << ": plus de 4 Gio de texte, trop pour un snapshot ; import abandonné\n";
+    return Snapshot{};
+  }
+  if (SNAP_PERSIST && src.ok) {
+    PROFILE_ZONE("snapshot/write");
+    write_snapshot(snap_path, image);
+  }
+  auto snap = Snapshot::from_image(std::move(image), kind);
+  PROFILE_COUNT("csv rows parsed", snap.rows());
+  return snap;
+}
@@ -0,0 +1,116 @@
+#include "TextFold.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// U+00C0..U+00FF -> équivalent ASCII minuscule (0 = pas de repli)
+static const char* const LATIN1_FOLD[64] = {
+  "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",  // C0-CF
+  "d", "n", "o", "o", "o", "o", "o", nullptr, "o", "u", "u", "u", "u", "y", nullptr, "ss", // D0-DF
+  "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",  // E0-EF
+  "d", "n", "o", "o", "o", "o", "o", nullptr, "o", "u", "u", "u", "u", "y", nullptr, "y",  // F0-FF
+};
+
+std::string fold_text(std::string_view s) {
+  std::string out;
+  out.reserve(s.size());
+  for (size_t i = 0; i < s.size(); ++i) {
+    const auto c = static_cast<unsigned char>(s[i]);
+    if (c < 0x80) {
+      out += (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : char(c);
+      continue;
+    }
+    if (i + 1 < s.size()) {
+      const auto c2 = static_cast<unsigned char>(s[i + 1]);
+      if (c == 0xC3 && c2 >= 0x80 && c2 <= 0xBF && LATIN1_FOLD[c2 - 0x80]) {
+        out += LATIN1_FOLD[c2 - 0x80];
+        ++i;
+        continue;
+      }
+      if (c == 0xC5 && (c2 == 0x92 || c2 == 0x93)) { // Œ œ
+        out += "oe";
+        ++i;
+        continue;
+      }
+    }
+    out += char(c);
+  }
+  return out;
+}
+
+// Myers / Hyyrö : une colonne de la matrice de Levenshtein tient dans les
+// bits d'un mot (|a| <= 64), la distance coûte O(|b|) opérations.
+static int edit_distance_bits(std::string_view a, std::string_view b, int bound) {
+  thread_local uint64_t peq[256] = {};
+  const size_t m = a.size();
+  for (size_t i = 0; i < m; ++i) peq[static_cast<unsigned char>(a[i])] |= uint64_t{1} << i;
+
+  const uint64_t last = uint64_t{1} << (m - 1);
+  uint64_t pv = ~uint64_t{0}, mv = 0;
+  int score = static_cast<int>(m);
+  const int n = static_cast<int>(b.size());
+  for (int j = 0; j < n; ++j) {
+    const uint64_t eq = peq[static_cast<unsigned char>(b[j])];
+    const uint64_t xv = eq | mv;
+    const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    if (ph & last) ++score;
+    if (mh & last) --score;
+    ph = (ph << 1) | 1; // ligne 0 : D[0][j] = j
+    mh <<= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    // chaque colonne restante fait baisser le score d'au plus 1
+    if (score - (n - 1 - j) > bound) { score = bound + 1; break; }
+  }
+  for (size_t i = 0; i < m; ++i) peq[static_cast<unsigned char>(a[i])] = 0;
+  return std::min(score, bound + 1);
+}
+
+int edit_distance(std::string_view a, std::string_view b, int bound) {
+  if (a.size() < b.size()) std::swap(a, b);
+  const int la = static_cast<int>(a.size()), lb = static_cast<int>(b.size());
+  if (la - lb > bound) return bound + 1;
+  if (lb == 0) return std::min(la, bound + 1);
+  if (lb <= 64) return edit_distance_bits(b, a, bound);
+
+  thread_local std::vector<int> prev, cur;
+  prev.resize(lb + 1);
+  cur.resize(lb + 1);
+  for (int j = 0; j <= lb; ++j) prev[j] = j;
+
+  for (int i = 1; i <= la; ++i) {
+    cur[0] = i;
+    int row_min = cur[0];
+    for (int j = 1; j <= lb; ++j) {
+      const int sub = prev[j - 1] + (a[i - 1] != b[j - 1]);
+      cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, sub});
+      row_min = std::min(row_min, cur[j]);
+    }
+    if (row_min > bound) return bound + 1;
+    std::swap(prev, cur);
+  }
+  return std::min(prev[lb], bound + 1);
+}
+
+int typo_distance(std::string_view a, std::string_view b) {
+  const size_t la = a.size(), lb = b.size();
+  thread_local std::vector<int> r0, r1, r2; // lignes i-2, i-1, i
+  r0.assign(lb + 1, 0);
+  r1.resize(lb + 1);
+  r2.resize(lb + 1);
+  for (size_t j = 0; j <= lb; ++j) r1[j] = static_cast<int>(j);
+
+  for (size_t i = 1; i <= la; ++i) {
+    r2[0] = static_cast<int>(i);
+    for (size_t j = 1; j <= lb; ++j) {
+      int v = std::min({r1[j] + 1, r2[j - 1] + 1, r1[j - 1] + (a[i - 1] != b[j - 1])});
+      if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) v = std::min(v, r0[j - 2] + 1);
+      r2[j] = v;
+    }
+    std::swap(r0, r1);
+    std::swap(r1, r2);
+  }
+  return r1[lb];
+}
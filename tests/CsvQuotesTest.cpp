@@ -0,0 +1,182 @@
+// Guillemets mal formés dans les CSV : une ligne abîmée ne doit pas
+// emporter les lignes suivantes (CsvReader, import des extras, import de
+// produits).
+#include "Calculator.hpp"
+#include "Csv.hpp"
+#include "Extra.hpp"
+#include "ProductImport.hpp"
+#include "Record.hpp"
+#include "Snapshot.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: échec: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                     \
+        }                                                                     \
+    } while (0)
+
+// Un guillemet isolé dans un commentaire hérité, puis un commentaire coupé
+// en plein champ entre guillemets.
+constexpr std::string_view STRAY_QUOTE =
+    "date,kcal,prot,fiber,comment\n"
+    "2026-01-01,800,0,0,pizza 12\"\n"
+    "2026-01-02,500,0,0,\"riz, poulet\"\n"
+    "2026-01-03,300,0,0,soupe\n";
+
+constexpr std::string_view CUT_QUOTE =
+    "date,kcal,prot,fiber,comment\n"
+    "2026-01-01,800,0,0,\"midi, soi\n"
+    "2026-01-02,500,0,0,\"riz, poulet\"\n"
+    "2026-01-03,300,0,0,soupe\n";
+
+std::vector<std::vector<std::string>> read_all(std::string_view text) {
+    std::vector<std::vector<std::string>> rows;
+    auto reader = CsvReader::from_text(text);
+    std::span<const std::string_view> c;
+    while (reader.next(c)) rows.emplace_back(c.begin(), c.end());
+    return rows;
+}
+
+void test_reader() {
+    const auto stray = read_all(STRAY_QUOTE);
+    CHECK(stray.size() == 4);
+    if (stray.size() == 4) {
+        CHECK(stray[1].size() == 5 && stray[1][4] == "pizza 12\"");
+        CHECK(stray[2].size() == 5 && stray[2][4] == "riz, poulet");
+        CHECK(stray[3][0] == "2026-01-03");
+    }
+
+    const auto cut = read_all(CUT_QUOTE);
+    CHECK(cut.size() == 4);
+    if (cut.size() == 4) {
+        CHECK(cut[2].size() == 5 && cut[2][4] == "riz, poulet");
+        CHECK(cut[3][0] == "2026-01-03");
+    }
+
+    // la ligne coupée est signalée, les autres non
+    auto reader = CsvReader::from_text(CUT_QUOTE);
+    std::span<const std::string_view> c;
+    std::vector<bool> open;
+    while (reader.next(c)) open.push_back(reader.open_quote());
+    CHECK((open == std::vector<bool>{false, true, false, false}));
+}
+
+// Une ligne coupée compte pour une ligne rejetée, avec sa raison.
+void test_row_issues() {
+    auto reader = CsvReader::from_text(CUT_QUOTE);
+    std::span<const std::string_view> c;
+    reader.next(c);
+    record::RowIssues issues;
+    record::RowError err;
+    ExtraView e;
+    size_t accepted = 0;
+    while (reader.next(c)) {
+        if (record::decode(reader, c, e, err)) ++accepted;
+        else issues.note(reader.record(), err);
+    }
+    CHECK(accepted == 2);
+    CHECK(issues.rejected == 1);
+    CHECK(issues.first.reason == "guillemet non fermé");
+
+    std::ostringstream out;
+    record::report<ExtraView>(out, "extras.csv", CUT_QUOTE, true, issues);
+    CHECK(out.str().find("1 ligne(s) ignorée(s) ; ligne 2") != std::string::npos);
+}
+
+// Les tranches du parse parallèle donnent les mêmes lignes que le parse
+// série, guillemets isolés ou coupés compris.
+void test_ranges() {
+    std::string text;
+    for (int i = 0; i < 200; ++i) {
+        text += "2026-01-01,";
+        text += std::to_string(i);
+        text += (i % 7 == 0) ? ",0,0,pizza 12\"\n" : (i % 11 == 0) ? ",0,0,\"midi, soi\n" : ",0,0,\"a, b\"\n";
+    }
+    const auto serial = read_all(text);
+    for (size_t parts = 2; parts <= 9; ++parts) {
+        std::vector<std::vector<std::string>> rows;
+        for (std::string_view r : split_record_ranges(text, parts)) {
+            CHECK(r.empty() || r.back() == '\n');
+            for (auto& row : read_all(r)) rows.push_back(std::move(row));
+        }
+        CHECK(rows == serial);
+    }
+    // coupe de bloc : jamais au milieu d'une ligne, même après un guillemet ouvert
+    const std::string_view cut = "a,\"x\nb,1\nc,\"y";
+    CHECK(complete_records_prefix(cut) == 9);
+}
+
+// Chemin complet de `food rebuild` : les trois jours sont importés.
+void test_extras_import(const std::filesystem::path& dir, std::string_view name, std::string_view text,
+                        size_t expected_rows) {
+    const auto csv = (dir / name).string();
+    std::ofstream(csv, std::ios::binary) << text;
+    const Snapshot snap = load_extras_snapshot(csv);
+    CHECK(snap.rows() == expected_rows);
+    if (snap.rows() == expected_rows) {
+        CHECK(snap.i32(snapcol::E_DATE).back() == make_date(2026, 1, 3).serial);
+    }
+}
+
+// Import de produits : un guillemet jamais fermé ne touche que sa ligne et
+// une ligne plus longue qu'un bloc est sautée sans faire grossir le tampon.
+void test_product_import(const std::filesystem::path& dir) {
+    const auto source = (dir / "source.csv").string();
+    const auto catalog = (dir / "food_products.csv").string();
+    {
+        std::ofstream src(source, std::ios::binary);
+        src << "code,product_name,energy-kcal_100g\n"
+            << "1,\"pain, complet,250\n"
+            << "2,riz,130\n"
+            << "3," << std::string(20000, 'x') << ",100\n"
+            << "4,soupe,40\n";
+    }
+    std::ofstream(catalog, std::ios::binary) << "id,name,unit,kcal_per_100,prot_per_100,fiber_per_100,aliases\n";
+
+    ProductDB db;
+    ProductImportOptions opt;
+    opt.chunk_bytes = 4096;
+    ProductImportReport report;
+    std::string error;
+    CHECK(import_products_file(db, catalog, source, opt, report, error));
+    CHECK(report.rows == 4);
+    CHECK(report.added == 2);
+    CHECK(report.invalid == 2);
+    CHECK(read_lines(catalog).size() == 3);
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        CHECK(entry.path().filename().string().find(".tmp.") == std::string::npos);
+    }
+}
+
+} // namespace
+
+int main() {
+    test_reader();
+    test_row_issues();
+    test_ranges();
+
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("dailyapp-csv-quotes-" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    test_extras_import(dir, "stray_extras.csv", STRAY_QUOTE, 3);
+    test_extras_import(dir, "cut_extras.csv", CUT_QUOTE, 2);
+    test_product_import(dir);
+    std::filesystem::remove_all(dir);
+
+    if (g_failures) std::fprintf(stderr, "%d échec(s)\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+// Recherche approchée : un mot partagé par plusieurs noms de produits
+// renvoie tous ces produits (draft-add les liste au lieu d'en choisir un).
+#include "ProductDB.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: échec: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                     \
+        }                                                                     \
+    } while (0)
+
+// Nombre de produits à la meilleure distance (1 = choix net).
+size_t best_count(const ProductDB& db, std::string_view query) {
+    const auto matches = db.fuzzy(query);
+    size_t n = 0;
+    while (n < matches.size() && matches[n].distance == matches[0].distance) ++n;
+    return n;
+}
+
+} // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("dailyapp-product-fuzzy-" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    const auto csv = (dir / "food_products.csv").string();
+    std::ofstream(csv, std::ios::binary)
+        << "id,name,unit,kcal_per_100,prot_per_100,fiber_per_100,aliases\n"
+        << "paindemie,Pain de mie,g,265,8,3,\n"
+        << "paincomplet,Pain complet,g,247,9,7,\n"
+        << "riz,Riz basmati,g,350,7,1,\n";
+
+    ProductDB db;
+    CHECK(db.load(csv));
+    CHECK(best_count(db, "pain") == 2);
+    CHECK(best_count(db, "pian") == 2);
+    CHECK(best_count(db, "basmta") == 1);
+    if (const auto m = db.fuzzy("basmta"); !m.empty()) CHECK(db.view(m[0].product).id == "riz");
+
+    std::filesystem::remove_all(dir);
+    if (g_failures) std::fprintf(stderr, "%d échec(s)\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+// Journal des pesées : une écriture interrompue en fin de journal ne doit
+// pas emporter la mesure suivante, et un journal non inscriptible est
+// signalé au lieu d'annoncer un ajout.
+#include "Storage.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: échec: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                     \
+        }                                                                     \
+    } while (0)
+
+void test_torn_tail(const std::filesystem::path& dir) {
+    const auto csv = (dir / "weight_history.csv").string();
+    const auto log = (dir / "weight_history.log").string();
+    {
+        Storage storage(csv);
+        CHECK(storage.upsertByDate({make_date(2026, 1, 4), 80.0}) == false);
+    }
+    std::ofstream(log, std::ios::binary | std::ios::app) << "U,2026-01-0";
+
+    Storage storage(csv);
+    CHECK(storage.upsertByDate({make_date(2026, 1, 5), 79.0}) == false);
+    const auto rows = Storage(csv).loadAll();
+    CHECK(rows.size() == 2);
+    if (rows.size() == 2) {
+        CHECK(rows[1].date == make_date(2026, 1, 5));
+        CHECK(rows[1].weightKg == 79.0);
+    }
+}
+
+void test_unwritable_log(const std::filesystem::path& dir) {
+    const auto csv = (dir / "weight_history.csv").string();
+    std::ofstream(csv, std::ios::binary) << "date,weight_kg\n2026-01-04,80\n";
+    // un dossier à la place du journal : ouverture impossible
+    std::filesystem::create_directories(dir / "weight_history.log");
+
+    Storage storage(csv);
+    CHECK(!storage.upsertByDate({make_date(2026, 1, 6), 78.0}).has_value());
+    CHECK(!storage.removeByDate(make_date(2026, 1, 4)).has_value());
+}
+
+} // namespace
+
+int main() {
+    const auto root = std::filesystem::temp_directory_path() /
+                      ("dailyapp-weight-log-" + std::to_string(::getpid()));
+    std::filesystem::create_directories(root / "torn");
+    std::filesystem::create_directories(root / "unwritable");
+    test_torn_tail(root / "torn");
+    test_unwritable_log(root / "unwritable");
+    std::filesystem::remove_all(root);
+
+    if (g_failures) std::fprintf(stderr, "%d échec(s)\n", g_failures);
+    return g_failures ? 1 : 0;
+}
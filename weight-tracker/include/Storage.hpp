@@ -1,28 +1,90 @@
 #pragma once
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include "WeightEntry.hpp"
 
+class AppendBatch;
+
+// Stockage log-structuré :
+//   weight_history.csv : base triée par date (lue par les scripts analytics)
+//   weight_history.log : journal append-only des écritures depuis la
+//                        dernière compaction ("U,date,kg" ou "D,date")
+// Une écriture = recherche dichotomique dans la base projetée + une ligne
+// ajoutée au journal ; la base n'est réécrite qu'à la compaction.
 class Storage {
 public:
     explicit Storage(std::string csvPath);
+    ~Storage();
 
-    // Load all entries from CSV (sorted by date ascending)
+    // Load all entries (base + journal, sorted by date ascending)
     std::vector<WeightEntry> loadAll() const;
 
-    // Append a new entry (adds header if file is new)
+    // Entrées de la plage seulement : dichotomie dans la base projetée (ou
+    // déjà parsée) puis lecture jusqu'à range.to, coût ~ taille du résultat.
+    std::vector<WeightEntry> loadRange(const DateRange& range) const;
+
+    // Append a new entry (same as upsertByDate, result ignored)
     void append(const WeightEntry& e) const;
 
-    // Replace entry if date exists; otherwise insert; keeps CSV sorted by date
-    // Returns true if replaced, false if inserted
-    bool upsertByDate(const WeightEntry& e) const;
+    // Replace entry if date exists; otherwise insert
+    // Returns true if replaced, false if inserted, nullopt if the journal
+    // could not be written
+    std::optional<bool> upsertByDate(const WeightEntry& e) const;
+
+    // Remove entry for a given date; returns true if removed, false if
+    // absent, nullopt if the journal could not be written
+    std::optional<bool> removeByDate(const Date& date) const;
+
+    // Réécrit la base avec le journal appliqué puis vide le journal.
+    void compact() const;
+
+    // Opérations en attente dans le journal
+    size_t pendingOps() const;
 
-    // Remove entry for a given date; returns true if removed
-    bool removeByDate(const std::string& date) const;
+    // DailyApp batch : les lignes du journal restent en mémoire jusqu'à
+    // commitWrites(), qui les écrit en un seul appel (et compacte si besoin).
+    // Les lectures voient déjà les écritures différées.
+    void deferWrites() const;
+    bool commitWrites() const;
+
+    // Au-delà, une écriture déclenche la compaction.
+    static constexpr size_t kCompactThreshold = 512;
 
 private:
     std::string path_;
+    std::string logPath_;
+
+    // taille + mtime : un objet Storage qui vit longtemps (DailyApp serve)
+    // ne relit un fichier que s'il a changé
+    struct FileStamp {
+        long long size = -1;
+        long long mtimeNs = 0;
+        friend bool operator==(const FileStamp&, const FileStamp&) = default;
+    };
+    static FileStamp stampOf(const std::string& path);
+
+    // dernier état connu par date depuis la base (nullopt = suppression)
+    mutable std::map<Date, std::optional<double>> log_;
+    mutable size_t logOps_ = 0;
+    mutable FileStamp logStamp_{};
+    mutable bool logLoaded_ = false;
+    mutable std::unique_ptr<AppendBatch> deferred_; // non nul pendant un batch
+
+    mutable std::vector<WeightEntry> base_; // base parsée, triée
+    mutable FileStamp baseStamp_{};
+    mutable bool baseSorted_ = true;
+    mutable bool baseLoaded_ = false;
 
+    void loadLog() const;
+    void loadBase() const;
+    bool scanBaseRange(const DateRange& range, std::vector<WeightEntry>& out) const;
+    std::optional<double> lookup(const Date& date) const;
+    std::optional<double> lookupBase(const Date& date) const;
+    bool appendLog(const Date& date, std::optional<double> weightKg) const; // faux si non écrit
     void ensureHeaderIfNeeded() const;
-    void rewriteAll(const std::vector<WeightEntry>& rows) const;
+    bool rewriteAll(const std::vector<WeightEntry>& rows) const;
+    void installBase(const std::vector<WeightEntry>& rows) const; // base = rows, journal vidé
 };
@@ -0,0 +1,90 @@
+#pragma once
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+#include "WeightEntry.hpp"
+
+// Tendances du poids calculées en flux : chaque accumulateur est mis à jour
+// en O(1) (amorti) par mesure, dans l'ordre des dates. Les fenêtres sont en
+// jours calendaires (mesures manquantes tolérées).
+
+// Moyenne des mesures des `days` derniers jours (jour courant inclus).
+class MovingAverage {
+public:
+    explicit MovingAverage(int days) : days_(days) {}
+    void push(const Date& date, double kg);
+    std::optional<double> value() const;
+
+private:
+    int days_;
+    std::deque<WeightEntry> window_;
+    double sum_ = 0.0;
+};
+
+// Moyenne exponentielle : chaque jour écoulé garde (1 - alpha) de l'ancienne
+// valeur, un trou de n jours compte donc comme n pas.
+class Ewma {
+public:
+    explicit Ewma(double alphaPerDay) : alpha_(alphaPerDay) {}
+    void push(const Date& date, double kg);
+    std::optional<double> value() const;
+
+private:
+    double alpha_;
+    std::optional<double> value_;
+    Date last_{};
+};
+
+// Régression linéaire (moindres carrés) sur les `days` derniers jours,
+// 0 = tout l'historique. Sommes glissantes : ajout et retrait en O(1).
+class LinearTrend {
+public:
+    explicit LinearTrend(int days) : days_(days) {}
+    void push(const Date& date, double kg);
+    std::optional<double> slopePerDay() const; // au moins 2 jours distincts
+
+private:
+    void add(double x, double y, double sign);
+
+    int days_;
+    std::deque<WeightEntry> window_;
+    int32_t origin_ = 0; // x = jours depuis origin_ (sommes bien conditionnées)
+    double n_ = 0, sx_ = 0, sy_ = 0, sxx_ = 0, sxy_ = 0;
+};
+
+struct TrendPoint {
+    Date date{};
+    double weightKg = 0.0;
+    std::optional<double> ma7, ma30, ewma;
+    std::optional<double> slopeKgPerWeek;
+};
+
+// MA 7 / 30 jours, EWMA (alpha 0.1 / jour) et pente sur 30 jours.
+class TrendEngine {
+public:
+    TrendEngine();
+
+    // Mesures à dates strictement croissantes ; faux (ignorée) sinon.
+    bool push(const WeightEntry& e);
+    const std::optional<TrendPoint>& last() const { return last_; }
+    size_t samples() const { return samples_; }
+
+    // Date à laquelle la tendance (EWMA + pente) atteint `targetKg`, si elle
+    // va dans ce sens.
+    std::optional<Date> projectedDate(double targetKg) const;
+
+private:
+    MovingAverage ma7_, ma30_;
+    Ewma ewma_;
+    LinearTrend slope_;
+    std::optional<TrendPoint> last_;
+    size_t samples_ = 0;
+};
+
+// Série complète (un point par mesure), pour l'export.
+std::vector<TrendPoint> computeTrend(const std::vector<WeightEntry>& rows);
+
+// CSV date,weight_kg,ma7,ma30,ewma,slope_kg_week (champ vide = pas assez de
+// mesures) ; écrit à côté puis renommé.
+bool exportTrendCsv(const std::vector<TrendPoint>& points, const std::string& path);
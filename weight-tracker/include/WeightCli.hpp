@@ -1,7 +1,28 @@
 #pragma once
+#include <cstdint>
+#include <iosfwd>
 #include <span>
 #include <string_view>
+#include "Storage.hpp"
+#include "Trend.hpp"
 
 namespace weight {
+    // Données gardées entre deux commandes d'un même processus (DailyApp
+    // serve) : Storage garde la base et le journal parsés tant que les
+    // fichiers ne changent pas, trend les accumulateurs de tendance (mis à
+    // jour à chaque `add` en fin d'historique, recalculés sinon). Non
+    // thread-safe : une commande à la fois.
+    struct Session {
+        Session();
+        Storage storage;
+        TrendEngine trend;
+        uint64_t trendDigest = 0; // empreinte des mesures poussées dans trend
+    };
+
+    // Commandes qui ne modifient aucun fichier.
+    bool is_read_only(std::span<const std::string_view> args);
+
     int run(std::span<const std::string_view> args);
+    int run(Session& session, std::span<const std::string_view> args,
+            std::ostream& out, std::ostream& err);
 }
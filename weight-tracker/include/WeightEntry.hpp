@@ -1,7 +1,17 @@
 #pragma once
-#include <string>
+#include "Date.hpp"
+#include "Record.hpp"
 
 struct WeightEntry {
-    std::string date;   // "YYYY-MM-DD"
+    Date date{};   // stored as "YYYY-MM-DD"
     double weightKg = 0.0;
 };
+
+// weight.csv: date,weight_kg
+template <>
+struct record::Schema<WeightEntry> {
+    static constexpr auto columns = std::tuple{
+        record::column("date", &WeightEntry::date),
+        record::column("weight_kg", &WeightEntry::weightKg),
+    };
+};
@@ -1,111 +1,346 @@
 #include "Storage.hpp"
+#include "Csv.hpp"
+#include "Profile.hpp"
 #include <filesystem>
 
 #include <algorithm>
 #include <fstream>
-#include <sstream>
+#include <iostream>
+#include <iterator>
 
-static std::string trim(const std::string& s) {
-    const auto a = s.find_first_not_of(" \t\r\n");
-    const auto b = s.find_last_not_of(" \t\r\n");
-    if (a == std::string::npos) return "";
-    return s.substr(a, b - a + 1);
+#include <sys/stat.h>
+
+// "date,weight" -> entrée ; faux pour une ligne vide ou invalide
+static bool parseRow(std::string_view line, WeightEntry& e) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    const size_t comma = line.find(',');
+    if (comma == std::string_view::npos) return false;
+    const std::string_view fields[] = {trim_view(line.substr(0, comma)), trim_view(line.substr(comma + 1))};
+    return record::decode(std::span(fields), e);
 }
 
-Storage::Storage(std::string csvPath) : path_(std::move(csvPath)) {}
+Storage::Storage(std::string csvPath)
+    : path_(std::move(csvPath)),
+      logPath_(std::filesystem::path(path_).replace_extension(".log").string()) {}
+
+Storage::~Storage() = default;
 
 void Storage::ensureHeaderIfNeeded() const {
     std::ifstream in(path_);
     if (in.good() && in.peek() != std::ifstream::traits_type::eof()) return;
 
     std::ofstream out(path_, std::ios::trunc);
-    out << "date,weight_kg\n";
+    out << record::header<WeightEntry>() << '\n';
 }
 
-std::vector<WeightEntry> Storage::loadAll() const {
-    ensureHeaderIfNeeded();
+Storage::FileStamp Storage::stampOf(const std::string& path) {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0) return {};
+    return {static_cast<long long>(st.st_size),
+            static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec};
+}
 
-    std::ifstream in(path_);
-    std::vector<WeightEntry> rows;
+void Storage::loadLog() const {
+    // pendant un batch, log_ contient des écritures pas encore sur disque
+    if (logLoaded_ && deferred_) return;
+    const FileStamp stamp = stampOf(logPath_);
+    if (logLoaded_ && stamp == logStamp_) return;
+    PROFILE_ZONE("Storage::loadLog");
+    logLoaded_ = true;
+    logStamp_ = stamp;
+    log_.clear();
+    logOps_ = 0;
 
-    std::string line;
-    bool first = true;
-    while (std::getline(in, line)) {
-        if (first) { first = false; continue; }  // skip header
-        line = trim(line);
-        if (line.empty()) continue;
+    MappedFile file(logPath_);
+    const std::string_view text = file.data();
+    // une dernière ligne sans '\n' est une écriture interrompue : ignorée
+    auto reader = CsvReader::from_text(text.substr(0, complete_records_prefix(text)));
+    std::span<const std::string_view> c;
+    while (reader.next(c)) {
+        Date d{};
+        if (c.size() < 2 || !parse_date_yyyy_mm_dd(c[1], d)) continue;
+        double kg = 0.0;
+        if (c[0] == "U" && c.size() >= 3 && parse_double(c[2], kg)) log_[d] = kg;
+        else if (c[0] == "D") log_[d] = std::nullopt;
+        else continue;
+        ++logOps_;
+    }
+    PROFILE_COUNT("csv rows parsed", logOps_);
+}
 
-        // very simple CSV: date,weight
-        std::stringstream ss(line);
-        std::string date, weightStr;
+// Dichotomie sur la base projetée : elle est triée par date (compaction).
+std::optional<double> Storage::lookupBase(const Date& date) const {
+    PROFILE_ZONE("Storage::lookupBase");
+    MappedFile file(path_, MappedFile::Access::Random);
+    const std::string_view text = file.data();
+    size_t lo = text.find('\n');
+    if (lo == std::string_view::npos) return std::nullopt;
+    ++lo; // après l'en-tête
+    size_t hi = text.size();
 
-        if (!std::getline(ss, date, ',')) continue;
-        if (!std::getline(ss, weightStr)) continue;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        // ligne contenant mid ; lo étant un début de ligne, start ∈ [lo, mid]
+        const size_t nl = text.rfind('\n', mid == 0 ? 0 : mid - 1);
+        const size_t start = (nl == std::string_view::npos || nl < lo) ? lo : nl + 1;
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos || end > hi) end = hi;
 
         WeightEntry e;
-        e.date = trim(date);
-
-        try {
-            e.weightKg = std::stod(trim(weightStr));
-        } catch (...) {
-            continue;
+        if (!parseRow(text.substr(start, end - start), e)) {
+            // ligne vide ou éditée à la main : recherche linéaire sur le reste
+            for (size_t pos = lo; pos < hi;) {
+                size_t eol = text.find('\n', pos);
+                if (eol == std::string_view::npos || eol > hi) eol = hi;
+                if (parseRow(text.substr(pos, eol - pos), e) && e.date == date) return e.weightKg;
+                pos = eol + 1;
+            }
+            return std::nullopt;
         }
+        if (e.date == date) return e.weightKg;
+        if (e.date < date) lo = end + 1;
+        else hi = start;
+    }
+    return std::nullopt;
+}
+
+std::optional<double> Storage::lookup(const Date& date) const {
+    loadLog();
+    if (auto it = log_.find(date); it != log_.end()) return it->second;
+    if (baseLoaded_) {
+        // base déjà parsée (session longue) : dichotomie en mémoire
+        loadBase();
+        auto it = std::upper_bound(base_.begin(), base_.end(), date,
+                                   [](const Date& d, const WeightEntry& e) { return d < e.date; });
+        if (it != base_.begin() && std::prev(it)->date == date) return std::prev(it)->weightKg;
+        return std::nullopt;
+    }
+    return lookupBase(date);
+}
 
-        rows.push_back(e);
+bool Storage::appendLog(const Date& date, std::optional<double> weightKg) const {
+    PROFILE_ZONE("Storage::appendLog");
+    loadLog();
+
+    std::string line = weightKg ? "U," : "D,";
+    line += format_date(date);
+    if (weightKg) {
+        line += ',';
+        record::Codec<double>::encode(line, *weightKg);
+    }
+
+    if (deferred_) {
+        deferred_->add(line);
+        log_[date] = weightKg;
+        ++logOps_; // compaction éventuelle au commit
+        return true;
     }
 
-    std::sort(rows.begin(), rows.end(),
-              [](const WeightEntry& a, const WeightEntry& b) { return a.date < b.date; });
+    // AppendBatch d'une ligne : une fin de journal coupée (écriture
+    // interrompue) est close par un '\n' avant l'ajout, un ajout raté est
+    // retiré du fichier
+    AppendBatch batch(logPath_);
+    batch.add(line);
+    if (!batch.commit()) return false;
+
+    log_[date] = weightKg;
+    if (++logOps_ >= kCompactThreshold) compact();
+    return true;
+}
 
+// Fusion d'une base triée (doublons : la dernière ligne gagne) et d'un
+// intervalle du journal, qui l'emporte à date égale.
+template <class LogIt>
+static std::vector<WeightEntry> mergeLog(const std::vector<WeightEntry>& base, LogIt it, LogIt end) {
+    std::vector<WeightEntry> rows;
+    rows.reserve(base.size() + static_cast<size_t>(std::distance(it, end)));
+    auto flushLogBefore = [&](const Date* bound) {
+        for (; it != end && (!bound || it->first < *bound); ++it) {
+            if (it->second) rows.push_back({it->first, *it->second});
+        }
+    };
+    for (size_t i = 0; i < base.size(); ++i) {
+        if (i + 1 < base.size() && base[i + 1].date == base[i].date) continue;
+        flushLogBefore(&base[i].date);
+        if (it != end && it->first == base[i].date) {
+            if (it->second) rows.push_back({it->first, *it->second});
+            ++it;
+        } else {
+            rows.push_back(base[i]);
+        }
+    }
+    flushLogBefore(nullptr);
     return rows;
 }
 
-void Storage::append(const WeightEntry& e) const {
+void Storage::loadBase() const {
+    const FileStamp stamp = stampOf(path_);
+    if (baseLoaded_ && stamp == baseStamp_) return;
+    PROFILE_ZONE("Storage::loadBase");
+    baseLoaded_ = true;
+    baseStamp_ = stamp;
+    base_.clear();
+
+    MappedFile file(path_);
+    auto reader = CsvReader::from_text(file.data());
+    std::span<const std::string_view> c;
+    const bool headerOk = !reader.next(c) || record::check_header<WeightEntry>(c);
+    record::RowIssues issues;
+    record::RowError error;
+    while (reader.next(c)) {
+        WeightEntry e;
+        if (!record::decode(reader, c, e, error)) {
+            issues.note(reader.record(), error);
+            continue;
+        }
+        base_.push_back(e);
+    }
+    PROFILE_COUNT("csv rows parsed", base_.size());
+    // ces lignes disparaîtront à la prochaine compaction : on le signale
+    record::report<WeightEntry>(std::cerr, path_, file.data(), headerOk, issues);
+
+    // base éditée à la main : on retrie (à date égale, la dernière ligne gagne)
+    // et loadAll la réécrit, la dichotomie de lookupBase en dépend
+    const auto byDate = [](const WeightEntry& a, const WeightEntry& b) { return a.date < b.date; };
+    baseSorted_ = std::is_sorted(base_.begin(), base_.end(), byDate);
+    if (!baseSorted_) std::stable_sort(base_.begin(), base_.end(), byDate);
+}
+
+std::vector<WeightEntry> Storage::loadAll() const {
+    PROFILE_ZONE("Storage::loadAll");
     ensureHeaderIfNeeded();
+    loadLog();
+    loadBase();
+    const auto& base = base_;
+    const bool sorted = baseSorted_;
 
-    std::ofstream out(path_, std::ios::app);
-    out << e.date << "," << e.weightKg << "\n";
+    const auto rows = mergeLog(base, log_.begin(), log_.end());
+    if (!sorted) installBase(rows);
+    return rows;
 }
-void Storage::rewriteAll(const std::vector<WeightEntry>& rows) const {
-    std::filesystem::create_directories(std::filesystem::path(path_).parent_path());
 
-    std::ofstream out(path_, std::ios::trunc);
-    out << "date,weight_kg\n";
-    for (const auto& e : rows) {
-        out << e.date << "," << e.weightKg << "\n";
+std::vector<WeightEntry> Storage::loadRange(const DateRange& range) const {
+    PROFILE_ZONE("Storage::loadRange");
+    if (!range.bounded()) return loadAll();
+    loadLog();
+
+    std::vector<WeightEntry> base;
+    if (baseLoaded_) loadBase(); // session longue : la base parsée sert d'index
+    const bool inMemory = baseLoaded_ && baseSorted_;
+    if (inMemory) {
+        const auto byDate = [](const WeightEntry& e, const Date& d) { return e.date < d; };
+        auto first = std::lower_bound(base_.begin(), base_.end(), range.from, byDate);
+        auto last = std::upper_bound(base_.begin(), base_.end(), range.to,
+                                     [](const Date& d, const WeightEntry& e) { return d < e.date; });
+        base.assign(first, std::max(first, last));
+    } else if (baseLoaded_ || !scanBaseRange(range, base)) {
+        // base non triée : chemin complet (qui la réécrit triée)
+        std::vector<WeightEntry> rows = loadAll();
+        std::erase_if(rows, [&](const WeightEntry& e) { return !range.contains(e.date); });
+        return rows;
     }
+    return mergeLog(base, log_.lower_bound(range.from), log_.upper_bound(range.to));
 }
 
-bool Storage::upsertByDate(const WeightEntry& e) const {
-    auto rows = loadAll();
+// Lignes de la plage lues dans la base projetée, à partir de la première
+// ligne >= range.from ; faux si la base n'est visiblement pas triée.
+bool Storage::scanBaseRange(const DateRange& range, std::vector<WeightEntry>& out) const {
+    MappedFile file(path_, MappedFile::Access::Random);
+    const std::string_view text = file.data();
+    const size_t header = text.find('\n');
+    if (header == std::string_view::npos) return true; // base vide
+    const auto start = seek_date_sorted(text, header + 1, range.from);
+    if (!start) return false;
 
-    bool replaced = false;
-    for (auto& r : rows) {
-        if (r.date == e.date) {
-            r.weightKg = e.weightKg;
-            replaced = true;
-            break;
+    for (size_t pos = *start; pos < text.size();) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        WeightEntry e;
+        const std::string_view line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+        if (!parseRow(line, e)) {
+            if (trim_view(line).empty()) continue;
+            return false;
         }
+        if (range.to < e.date) break;
+        if (!out.empty() && e.date < out.back().date) return false;
+        // à date égale, la dernière ligne gagne (comme loadBase)
+        if (!out.empty() && e.date == out.back().date) out.back() = e;
+        else out.push_back(e);
     }
-    if (!replaced) rows.push_back(e);
+    return true;
+}
 
-    std::sort(rows.begin(), rows.end(),
-              [](const WeightEntry& a, const WeightEntry& b) { return a.date < b.date; });
+void Storage::append(const WeightEntry& e) const {
+    (void)upsertByDate(e);
+}
 
-    rewriteAll(rows);
-    return replaced;
+bool Storage::rewriteAll(const std::vector<WeightEntry>& rows) const {
+    PROFILE_ZONE("Storage::rewriteAll");
+    std::filesystem::create_directories(std::filesystem::path(path_).parent_path());
+
+    std::string out = record::header<WeightEntry>();
+    out += '\n';
+    for (const auto& e : rows) {
+        record::encode(e, out);
+        out += '\n';
+    }
+
+    // fichier temporaire puis rename : la base n'est jamais à moitié écrite
+    const std::string tmp = temp_path_for(path_);
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        f.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!f) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path_, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+    return !ec;
 }
 
-bool Storage::removeByDate(const std::string& date) const {
-    auto rows = loadAll();
-    const auto before = rows.size();
+void Storage::installBase(const std::vector<WeightEntry>& rows) const {
+    if (!rewriteAll(rows)) return; // journal conservé
+    // après le rename : rejouer le journal sur la nouvelle base est sans effet
+    std::error_code ec;
+    std::filesystem::remove(logPath_, ec);
+    log_.clear();
+    logOps_ = 0;
+    // les écritures différées sont dans la nouvelle base
+    if (deferred_) deferred_ = std::make_unique<AppendBatch>(logPath_);
+}
 
-    rows.erase(std::remove_if(rows.begin(), rows.end(),
-                             [&](const WeightEntry& e) { return e.date == date; }),
-               rows.end());
+void Storage::compact() const {
+    installBase(loadAll());
+}
 
-    if (rows.size() == before) return false;
+void Storage::deferWrites() const {
+    loadLog();
+    if (!deferred_) deferred_ = std::make_unique<AppendBatch>(logPath_);
+}
+
+bool Storage::commitWrites() const {
+    if (!deferred_) return true;
+    const bool ok = deferred_->commit();
+    deferred_.reset();
+    logLoaded_ = false; // relu depuis le disque (lignes perdues si !ok)
+    if (ok && pendingOps() >= kCompactThreshold) compact();
+    return ok;
+}
+
+size_t Storage::pendingOps() const {
+    loadLog();
+    return logOps_;
+}
+
+std::optional<bool> Storage::upsertByDate(const WeightEntry& e) const {
+    const bool replaced = lookup(e.date).has_value();
+    if (!appendLog(e.date, e.weightKg)) return std::nullopt;
+    return replaced;
+}
 
-    rewriteAll(rows);
+std::optional<bool> Storage::removeByDate(const Date& date) const {
+    if (!lookup(date)) return false;
+    if (!appendLog(date, std::nullopt)) return std::nullopt;
     return true;
 }
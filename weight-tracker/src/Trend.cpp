@@ -0,0 +1,143 @@
+#include "Trend.hpp"
+#include "Csv.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+void MovingAverage::push(const Date& date, double kg) {
+    window_.push_back({date, kg});
+    sum_ += kg;
+    while (days_between(window_.front().date, date) >= days_) {
+        sum_ -= window_.front().weightKg;
+        window_.pop_front();
+    }
+}
+
+std::optional<double> MovingAverage::value() const {
+    if (window_.empty()) return std::nullopt;
+    return sum_ / static_cast<double>(window_.size());
+}
+
+void Ewma::push(const Date& date, double kg) {
+    if (!value_) {
+        value_ = kg;
+    } else {
+        const int dt = std::max(1, days_between(last_, date));
+        const double keep = std::pow(1.0 - alpha_, dt);
+        value_ = *value_ * keep + kg * (1.0 - keep);
+    }
+    last_ = date;
+}
+
+std::optional<double> Ewma::value() const {
+    return value_;
+}
+
+void LinearTrend::add(double x, double y, double sign) {
+    n_ += sign;
+    sx_ += sign * x;
+    sy_ += sign * y;
+    sxx_ += sign * x * x;
+    sxy_ += sign * x * y;
+}
+
+void LinearTrend::push(const Date& date, double kg) {
+    if (window_.empty()) {
+        origin_ = date.serial;
+        n_ = sx_ = sy_ = sxx_ = sxy_ = 0;
+    }
+    window_.push_back({date, kg});
+    add(date.serial - origin_, kg, +1);
+    while (days_ > 0 && days_between(window_.front().date, date) >= days_) {
+        add(window_.front().date.serial - origin_, window_.front().weightKg, -1);
+        window_.pop_front();
+    }
+}
+
+std::optional<double> LinearTrend::slopePerDay() const {
+    if (window_.size() < 2) return std::nullopt;
+    const double den = n_ * sxx_ - sx_ * sx_;
+    if (den <= 1e-9) return std::nullopt;
+    return (n_ * sxy_ - sx_ * sy_) / den;
+}
+
+TrendEngine::TrendEngine() : ma7_(7), ma30_(30), ewma_(0.1), slope_(30) {}
+
+bool TrendEngine::push(const WeightEntry& e) {
+    if (last_ && !(last_->date < e.date)) return false;
+    ma7_.push(e.date, e.weightKg);
+    ma30_.push(e.date, e.weightKg);
+    ewma_.push(e.date, e.weightKg);
+    slope_.push(e.date, e.weightKg);
+    ++samples_;
+
+    TrendPoint p;
+    p.date = e.date;
+    p.weightKg = e.weightKg;
+    p.ma7 = ma7_.value();
+    p.ma30 = ma30_.value();
+    p.ewma = ewma_.value();
+    if (auto s = slope_.slopePerDay()) p.slopeKgPerWeek = *s * 7.0;
+    last_ = p;
+    return true;
+}
+
+std::optional<Date> TrendEngine::projectedDate(double targetKg) const {
+    if (!last_ || !last_->ewma || !last_->slopeKgPerWeek) return std::nullopt;
+    const double perDay = *last_->slopeKgPerWeek / 7.0;
+    const double gap = targetKg - *last_->ewma;
+    if (std::abs(gap) < 1e-9) return last_->date;
+    if (std::abs(perDay) < 1e-6 || (gap > 0) != (perDay > 0)) return std::nullopt;
+    const double days = std::ceil(gap / perDay);
+    if (days > 3650 * 10) return std::nullopt; // plus de 100 ans : pas de sens
+    return add_days(last_->date, static_cast<int>(days));
+}
+
+std::vector<TrendPoint> computeTrend(const std::vector<WeightEntry>& rows) {
+    TrendEngine engine;
+    std::vector<TrendPoint> points;
+    points.reserve(rows.size());
+    for (const auto& e : rows) {
+        if (engine.push(e)) points.push_back(*engine.last());
+    }
+    return points;
+}
+
+static void appendField(std::string& out, const std::optional<double>& v) {
+    out += ',';
+    if (!v) return;
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", *v);
+    out += buf;
+}
+
+bool exportTrendCsv(const std::vector<TrendPoint>& points, const std::string& path) {
+    std::string out = "date,weight_kg,ma7,ma30,ewma,slope_kg_week\n";
+    for (const auto& p : points) {
+        out += format_date(p.date);
+        appendField(out, p.weightKg);
+        appendField(out, p.ma7);
+        appendField(out, p.ma30);
+        appendField(out, p.ewma);
+        appendField(out, p.slopeKgPerWeek);
+        out += '\n';
+    }
+
+    const auto parent = std::filesystem::path(path).parent_path();
+    std::error_code ec;
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+    const std::string tmp = temp_path_for(path);
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        f.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!f) {
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+    return !ec;
+}
@@ -4,26 +4,37 @@
 #include <string>
 #include <span>
 
+#include <bit>
 #include <cctype>
 #include <filesystem>
 #include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <optional>
 #include <sstream>
 #include <span>
 #include <string_view>
 
 
+#include "Chart.hpp"
+#include "Csv.hpp"
+#include "PlotCache.hpp"
+#include "Profile.hpp"
 #include "Storage.hpp"
+#include "Trend.hpp"
 
 
 
 namespace {
 
-void print_weight_help() {
-    std::cout <<
+void print_weight_help(std::ostream& out) {
+    out <<
 R"(Usage:
   ./DailyApp weight add <YYYY-MM-DD> <weight><kg|lb>
   ./DailyApp weight remove <YYYY-MM-DD>
-  ./DailyApp weight history
+  ./DailyApp weight history [--wait] [--from <YYYY-MM-DD>] [--to <YYYY-MM-DD>] [--last <days>]
+  ./DailyApp weight trend [--target <weight><kg|lb>] [--export <file.csv>]
+  ./DailyApp weight plot-status
 )";
 }
 
@@ -31,15 +42,6 @@ R"(Usage:
 
 namespace weight {
 
-static bool isValidDateYYYYMMDD(const std::string& d) {
-    if (d.size() != 10) return false;
-    if (d[4] != '-' || d[7] != '-') return false;
-    for (size_t i : {0u,1u,2u,3u,5u,6u,8u,9u}) {
-        if (!std::isdigit(static_cast<unsigned char>(d[i]))) return false;
-    }
-    return true;
-}
-
 static double lbToKg(double lb) { return lb / 2.20462262185; }
 static double kgToLb(double kg) { return kg * 2.20462262185; }
 
@@ -58,7 +60,7 @@ static bool parseWeightTokenToKg(const std::string& token, double& outKg) {
     for (auto& c : unit) c = static_cast<char>(std::tolower((unsigned char)c));
 
     double value = 0.0;
-    try { value = std::stod(valueStr); } catch (...) { return false; }
+    if (!parse_double(valueStr, value)) return false;
     if (value <= 0.0 || value >= 1000.0) return false;
 
     if (unit == "kg") { outKg = value; return true; }
@@ -66,15 +68,15 @@ static bool parseWeightTokenToKg(const std::string& token, double& outKg) {
     return false;
 }
 
-static void printHistory(const std::vector<WeightEntry>& rows) {
+static void printHistory(const std::vector<WeightEntry>& rows, std::ostream& out) {
     if (rows.empty()) {
-        std::cout << "Historique vide.\n";
+        out << "Historique vide.\n";
         return;
     }
 
-    std::cout << "Historique du poids:\n";
+    out << "Historique du poids:\n";
     for (const auto& e : rows) {
-        std::cout << "  " << e.date
+        out << "  " << format_date(e.date)
                   << "  ->  " << e.weightKg << " kg"
                   << " (" << kgToLb(e.weightKg) << " lb)\n";
     }
@@ -82,10 +84,75 @@ static void printHistory(const std::vector<WeightEntry>& rows) {
     if (rows.size() >= 2) {
         const auto& prev = rows[rows.size() - 2];
         const auto& last = rows.back();
-        std::cout << "\nDernier changement: "
+        out << "\nDernier changement: "
                   << (last.weightKg - prev.weightKg) << " kg ("
                   << (kgToLb(last.weightKg) - kgToLb(prev.weightKg)) << " lb) "
-                  << "(" << prev.date << " -> " << last.date << ")\n";
+                  << "(" << format_date(prev.date) << " -> " << format_date(last.date) << ")\n";
+    }
+}
+
+static std::string fmtKg(double v, bool sign = false) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), sign ? "%+.2f" : "%.2f", v);
+    return buf;
+}
+
+// Empreinte des mesures poussées dans Session::trend : FNV-1a sur la date
+// et le poids, étendue mesure par mesure.
+constexpr uint64_t kDigestSeed = 1469598103934665603ULL;
+
+static uint64_t digestEntry(uint64_t h, const WeightEntry& e) {
+    const uint64_t words[2] = {static_cast<uint32_t>(e.date.serial), std::bit_cast<uint64_t>(e.weightKg)};
+    for (uint64_t w : words) {
+        for (int b = 0; b < 8; ++b) {
+            h ^= (w >> (8 * b)) & 0xff;
+            h *= 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+// Accumulateurs de la session alignés sur rows : seules les mesures pas
+// encore vues sont poussées, tout est rejoué si l'historique a changé
+// ailleurs qu'à la fin (remove, date antérieure, fichier édité). Une mesure
+// déjà vue et modifiée hors session se voit à l'empreinte : un parcours de
+// rows, bien moins cher que le rejeu.
+static const TrendEngine& syncTrend(Session& session, const std::vector<WeightEntry>& rows) {
+    PROFILE_ZONE("weight/trend");
+    TrendEngine& trend = session.trend;
+    const size_t n = trend.samples();
+    uint64_t h = kDigestSeed;
+    for (size_t i = 0; i < n && i < rows.size(); ++i) h = digestEntry(h, rows[i]);
+    if (n > rows.size() || h != session.trendDigest) {
+        trend = TrendEngine();
+        h = kDigestSeed;
+    }
+    for (size_t i = trend.samples(); i < rows.size(); ++i) {
+        trend.push(rows[i]);
+        h = digestEntry(h, rows[i]);
+    }
+    session.trendDigest = h;
+    return trend;
+}
+
+static void printTrend(const TrendEngine& trend, std::optional<double> targetKg, std::ostream& out) {
+    if (!trend.last()) {
+        out << "Tendance: aucune mesure.\n";
+        return;
+    }
+    const TrendPoint& p = *trend.last();
+    const auto line = [&](const char* label, const std::optional<double>& v, const char* unit, bool sign = false) {
+        out << "  " << label << (v ? fmtKg(*v, sign) + unit : std::string("n/a")) << "\n";
+    };
+    out << "Tendance au " << format_date(p.date) << " (" << trend.samples() << " mesures):\n";
+    line("Moyenne 7 j:     ", p.ma7, " kg");
+    line("Moyenne 30 j:    ", p.ma30, " kg");
+    line("EWMA (0.1/j):    ", p.ewma, " kg");
+    line("Pente sur 30 j:  ", p.slopeKgPerWeek, " kg/semaine", true);
+    if (targetKg) {
+        out << "  Objectif " << fmtKg(*targetKg) << " kg: ";
+        if (auto d = trend.projectedDate(*targetKg)) out << "vers le " << format_date(*d) << "\n";
+        else out << "pas atteint au rythme actuel\n";
     }
 }
 
@@ -93,7 +160,9 @@ static std::filesystem::path computeCsvPath() {
     return std::filesystem::path(DAILYAPP_DATA_DIR) / "weight_history.csv";
 }
 
-static int runWeightHistoryPlot() {
+// Ancien rendu matplotlib (DAILYAPP_PLOT=python), relit weight_history.csv.
+static int runWeightHistoryPlotPython(std::ostream& err) {
+    PROFILE_ZONE("plot/python subprocess");
     const std::filesystem::path root = std::filesystem::path(DAILYAPP_ROOT_DIR);
 
     const std::filesystem::path csv = computeCsvPath();
@@ -103,83 +172,260 @@ static int runWeightHistoryPlot() {
     const std::filesystem::path py = root / "analytics" / "weight_history.py";
 
     if (!std::filesystem::exists(py)) {
-        std::cerr << "[plot] Script not found: " << py << "\n";
+        err << "[plot] Script not found: " << py << "\n";
         return 127;
     }
 
+    // le script écrit à côté, l'image n'est remplacée qu'après un succès
+    // (suffixe .png : matplotlib en déduit le format)
+    const std::string tmp = temp_path_for(out.string()) + ".png";
     std::ostringstream cmd;
     cmd << "python3 "
         << "\"" << py.string() << "\""
         << " --csv " << "\"" << csv.string() << "\""
-        << " --out " << "\"" << out.string() << "\"";
-
-    const int rc = std::system(cmd.str().c_str());
-    if (rc != 0) {
-        std::cerr << "[plot] analytics failed (exit code " << rc << ")\n";
+        << " --out " << "\"" << tmp << "\"";
+
+    int rc = std::system(cmd.str().c_str());
+    std::error_code ec;
+    if (rc == 0) {
+        std::filesystem::rename(tmp, out, ec);
+        if (ec) {
+            err << "[plot] " << out.string() << ": " << ec.message() << "\n";
+            rc = 1;
+        }
+    } else {
+        err << "[plot] analytics failed (exit code " << rc << ")\n";
     }
+    if (rc != 0) std::filesystem::remove(tmp, ec);
     return rc;
 }
 
+static bool usePythonPlot() {
+    const char* mode = std::getenv("DAILYAPP_PLOT");
+    return mode && std::string_view(mode) == "python";
+}
+
+// weight_history.png / .svg rendus en C++ depuis les entrées chargées,
+// sautés si weight_history.plot a l'empreinte des mêmes entrées. Sans
+// `wait`, le rendu part en arrière-plan (cf. weight plot-status).
+static int runWeightHistoryPlot(const std::vector<WeightEntry>& rows, bool wait,
+                                std::ostream& out, std::ostream& err) {
+    const std::filesystem::path dir = std::filesystem::path(DAILYAPP_DATA_DIR);
+    const std::string png = (dir / "weight_history.png").string();
+
+    PlotJob job;
+    job.sidecar = (dir / "weight_history.plot").string();
+
+    if (usePythonPlot()) {
+        Fingerprint key;
+        key.add("python");
+        fingerprint_file(key, computeCsvPath().string());
+        fingerprint_file(key, (std::filesystem::path(DAILYAPP_ROOT_DIR) / "analytics" / "weight_history.py").string());
+        job.key = key.value();
+        job.outputs = {png};
+        job.render = [](std::ostream& e) { return runWeightHistoryPlotPython(e) == 0; };
+    } else {
+        if (rows.empty()) {
+            err << "[plot] Historique vide, rien a tracer.\n";
+            return 1;
+        }
+
+        Chart chart;
+        chart.title = "Weight tracker history";
+        chart.x_label = "Date";
+        chart.y[0].label = "Weight (kg)";
+        ChartSeries weight{"Weight (kg)", {}, {}, chart_colors::Blue};
+        weight.width = 1.5;
+        for (const auto& e : rows) {
+            weight.days.push_back(e.date.serial);
+            weight.values.push_back(e.weightKg);
+        }
+        chart.series.push_back(std::move(weight));
+
+        const std::string svg = (dir / "weight_history.svg").string();
+        job.key = chart_fingerprint(chart);
+        job.outputs = {png, svg};
+        // le job peut survivre à la commande (worker) : tout est copié
+        job.render = [chart = std::move(chart), png, svg](std::ostream& e) {
+            if (write_chart_png(chart, png) && write_chart_svg(chart, svg)) return true;
+            e << "[plot] cannot write " << png << " / " << svg << "\n";
+            return false;
+        };
+    }
+
+    switch (wait ? run_plot(job, err) : submit_plot(std::move(job))) {
+        case PlotStatus::Hit:      out << "Plot a jour (cache): " << png << "\n"; return 0;
+        case PlotStatus::Rendered: out << "Plot mis a jour: " << png << "\n"; return 0;
+        case PlotStatus::Queued:   out << "Plot en arriere-plan: " << png << " (weight plot-status)\n"; return 0;
+        case PlotStatus::Failed:   break;
+    }
+    return 1;
+}
+
+static int printPlotStatus(std::ostream& out) {
+    const std::string sidecar = (std::filesystem::path(DAILYAPP_DATA_DIR) / "weight_history.plot").string();
+    PlotState st;
+    if (!read_plot_state(sidecar, st)) {
+        out << "Aucun plot (lancer: weight history)\n";
+        return 1;
+    }
+    const long long age = static_cast<long long>(std::time(nullptr)) - st.updated;
+    out << "weight_history.png: " << st.state << " (il y a " << age << " s)\n";
+    if (!st.message.empty()) out << "  " << st.message << "\n";
+    return st.state == "failed" ? 1 : 0;
+}
+
+Session::Session() : storage(computeCsvPath().string()) {}
+
+bool is_read_only(std::span<const std::string_view> args) {
+    // history écrit le graphique (et compacte le journal avant un plot python),
+    // history et trend mettent à jour les accumulateurs de la session
+    return args.empty() || args[0] == "--help" || args[0] == "-h" || args[0] == "plot-status";
+}
+
 int run(std::span<const std::string_view> args) {
+    Session session;
+    return run(session, args, std::cout, std::cerr);
+}
+
+int run(Session& session, std::span<const std::string_view> args, std::ostream& out, std::ostream& err) {
+    PROFILE_ZONE("weight::run");
     if (args.empty() || args[0] == "--help" || args[0] == "-h") {
-        print_weight_help();
+        print_weight_help(out);
         return 0;
     }
 
     const std::string_view cmd = args[0];
-    Storage storage(computeCsvPath().string());
+    const Storage& storage = session.storage;
 
     if (cmd == "history") {
-        if (args.size() != 1) { print_weight_help(); return 1; }
-        printHistory(storage.loadAll());
-        (void)runWeightHistoryPlot();
+        bool wait = false;
+        DateRange range;
+        for (size_t i = 1; i < args.size(); ++i) {
+            const RangeArg r = parse_range_arg(args, i, range);
+            if (r == RangeArg::Invalid) {
+                err << "Plage invalide. Exemple: --from 2026-01-01 --to 2026-01-31 ou --last 14\n";
+                return 2;
+            }
+            if (r == RangeArg::None) {
+                if (args[i] != "--wait") { print_weight_help(out); return 1; }
+                wait = true;
+            }
+        }
+
+        // plage : lecture des seules lignes concernées, ni tendance ni plot
+        if (range.bounded()) {
+            const auto rows = storage.loadRange(range);
+            if (rows.empty()) out << "Aucune entree sur la periode.\n";
+            else printHistory(rows, out);
+            return 0;
+        }
+
+        const auto rows = storage.loadAll();
+        printHistory(rows, out);
+        if (!rows.empty()) {
+            out << "\n";
+            printTrend(syncTrend(session, rows), std::nullopt, out);
+        }
+        // le script lit weight_history.csv : le journal doit y être appliqué
+        if (usePythonPlot() && storage.pendingOps() > 0) storage.compact();
+        const int rc = runWeightHistoryPlot(rows, wait, out, err);
+        return wait ? rc : 0;
+    }
+
+    if (cmd == "trend") {
+        std::optional<double> targetKg;
+        std::string exportPath;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (args[i] == "--target" && i + 1 < args.size()) {
+                double kg = 0.0;
+                if (!parseWeightTokenToKg(std::string(args[++i]), kg)) {
+                    err << "Poids invalide. Exemple: 62kg ou 143lb\n";
+                    return 2;
+                }
+                targetKg = kg;
+            } else if (args[i] == "--export" && i + 1 < args.size()) {
+                exportPath = std::string(args[++i]);
+            } else {
+                print_weight_help(out);
+                return 1;
+            }
+        }
+
+        const auto rows = storage.loadAll();
+        printTrend(syncTrend(session, rows), targetKg, out);
+        if (!exportPath.empty()) {
+            if (!exportTrendCsv(computeTrend(rows), exportPath)) {
+                err << "Export impossible: " << exportPath << "\n";
+                return 1;
+            }
+            out << "Exporte: " << exportPath << "\n";
+        }
         return 0;
     }
 
+    if (cmd == "plot-status") {
+        return printPlotStatus(out);
+    }
+
     if (cmd == "add") {
-        if (args.size() != 3) { print_weight_help(); return 1; }
-        const std::string date(args[1]);
+        if (args.size() != 3) { print_weight_help(out); return 1; }
+        Date date{};
         const std::string wtok(args[2]);
 
-        if (!isValidDateYYYYMMDD(date)) {
-            std::cerr << "Date invalide. Exemple: 2026-01-24\n";
+        if (!parse_date_yyyy_mm_dd(args[1], date)) {
+            err << "Date invalide. Exemple: 2026-01-24\n";
             return 2;
         }
 
         double kg = 0.0;
         if (!parseWeightTokenToKg(wtok, kg)) {
-            std::cerr << "Poids invalide. Exemple: 62kg ou 143lb\n";
+            err << "Poids invalide. Exemple: 62kg ou 143lb\n";
             return 2;
         }
 
         WeightEntry e{date, kg};
-        const bool replaced = storage.upsertByDate(e);
-        std::cout << (replaced ? "Mis a jour: " : "Ajoute: ")
-                  << date << " -> " << kg << " kg\n";
+        const std::optional<bool> written = storage.upsertByDate(e);
+        if (!written) {
+            err << "Ecriture impossible: " << computeCsvPath().replace_extension(".log").string() << "\n";
+            return 1;
+        }
+        const bool replaced = *written;
+        // nouvelle mesure en fin d'historique : une mise à jour O(1) ;
+        // sinon les accumulateurs seront rejoués à la prochaine lecture
+        if (replaced || session.trend.samples() == 0 || !session.trend.push(e)) session.trend = TrendEngine();
+        else session.trendDigest = digestEntry(session.trendDigest, e);
+        out << (replaced ? "Mis a jour: " : "Ajoute: ")
+                  << format_date(date) << " -> " << kg << " kg\n";
         return 0;
     }
 
     if (cmd == "remove") {
-        if (args.size() != 2) { print_weight_help(); return 1; }
-        const std::string date(args[1]);
+        if (args.size() != 2) { print_weight_help(out); return 1; }
+        Date date{};
 
-        if (!isValidDateYYYYMMDD(date)) {
-            std::cerr << "Date invalide. Exemple: 2026-01-24\n";
+        if (!parse_date_yyyy_mm_dd(args[1], date)) {
+            err << "Date invalide. Exemple: 2026-01-24\n";
             return 2;
         }
 
-        const bool removed = storage.removeByDate(date);
+        const std::optional<bool> removed = storage.removeByDate(date);
         if (!removed) {
-            std::cerr << "Aucune entree a supprimer pour la date " << date << "\n";
+            err << "Ecriture impossible: " << computeCsvPath().replace_extension(".log").string() << "\n";
+            return 1;
+        }
+        if (!*removed) {
+            err << "Aucune entree a supprimer pour la date " << format_date(date) << "\n";
             return 3;
         }
 
-        std::cout << "Supprime: " << date << "\n";
+        session.trend = TrendEngine();
+        out << "Supprime: " << format_date(date) << "\n";
         return 0;
     }
 
-    std::cerr << "Unknown weight command: " << cmd << "\n";
-    print_weight_help();
+    err << "Unknown weight command: " << cmd << "\n";
+    print_weight_help(out);
     return 2;
 }
 